@@ -0,0 +1,466 @@
+/*
+ * Copyright (C) 2020 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/**
+ * End to end benchmarks of a running ROS 1 SystemHandle.
+ *
+ * The benchmark process runs an Integration Service instance that bridges the mock middleware
+ * with ROS 1, while a child process runs a plain ROS 1 node that echoes every `bench_<type>_out`
+ * message back on `bench_<type>_in`. Each message published through the mock middleware is
+ * therefore converted to ROS 1 and published by the SystemHandle, and then received by one of
+ * its subscriptions and converted back to xTypes, before reaching the mock subscription.
+ *
+ * The `spin` block of the SystemHandle is built from the `--spin <event|poll|async>`,
+ * `--spin-period-ms <ms>` and `--spin-threads <count>` arguments, so that the spin modes
+ * can be compared by running the benchmark once for each of them.
+ */
+
+#include <is/sh/mock/api.hpp>
+#include <is/core/Instance.hpp>
+
+#include <ros/callback_queue.h>
+#include <ros/node_handle.h>
+#include <ros/spinner.h>
+
+#include <geometry_msgs/Pose.h>
+#include <sensor_msgs/Image.h>
+#include <std_msgs/String.h>
+
+#include <yaml-cpp/yaml.h>
+
+#include <benchmark/benchmark.h>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace is = eprosima::is;
+namespace xtypes = eprosima::xtypes;
+
+using namespace std::chrono_literals;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+//==============================================================================
+/**
+ * Counts the echoes received by the mock middleware on a topic.
+ */
+struct EchoCounter
+{
+    void notify()
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            ++received;
+        }
+        cv.notify_all();
+    }
+
+    bool wait_for(
+            uint64_t count,
+            std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return cv.wait_for(lock, timeout, [&]()
+                       {
+                           return received >= count;
+                       });
+    }
+
+    uint64_t value()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return received;
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    uint64_t received = 0;
+};
+
+std::unique_ptr<is::core::InstanceHandle> g_handle;
+EchoCounter g_echoes[3];
+
+/// Labels every benchmark with the spin mode it ran with.
+std::string g_spin_label;
+
+const char* const g_type_names[] = {"geometry_msgs/Pose", "std_msgs/String", "sensor_msgs/Image"};
+const char* const g_topic_names[] = {"bench_pose", "bench_string", "bench_image"};
+
+enum Topic
+{
+    POSE = 0,
+    STRING = 1,
+    IMAGE = 2
+};
+
+//==============================================================================
+xtypes::DynamicData make_message(
+        Topic topic,
+        std::size_t payload_size)
+{
+    const xtypes::DynamicType& type = *g_handle->type_registry("ros1")->at(g_type_names[topic]);
+    xtypes::DynamicData msg(type);
+
+    switch (topic)
+    {
+        case POSE:
+            msg["position"]["x"] = 1.0;
+            msg["orientation"]["w"] = 1.0;
+            break;
+        case STRING:
+            msg["data"] = std::string(payload_size, 'x');
+            break;
+        case IMAGE:
+            msg["height"] = static_cast<uint32_t>(1);
+            msg["width"] = static_cast<uint32_t>(payload_size / 3);
+            msg["step"] = static_cast<uint32_t>(payload_size);
+            msg["encoding"] = std::string("rgb8");
+            msg["data"].resize(payload_size);
+            break;
+    }
+
+    return msg;
+}
+
+//==============================================================================
+double percentile(
+        std::vector<double>& samples,
+        double ratio)
+{
+    if (samples.empty())
+    {
+        return 0.0;
+    }
+
+    const std::size_t index = std::min(
+        samples.size() - 1, static_cast<std::size_t>(ratio * samples.size()));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+//==============================================================================
+// Round trip latency of a single message, from the mock middleware to ROS 1 and back.
+void BM_RoundTrip(
+        benchmark::State& state,
+        Topic topic)
+{
+    const xtypes::DynamicData msg = make_message(topic, state.range(0));
+    const std::string out_topic = std::string(g_topic_names[topic]) + "_out";
+    EchoCounter& echoes = g_echoes[topic];
+
+    std::vector<double> samples_us;
+    samples_us.reserve(state.max_iterations);
+
+    for (auto _ : state)
+    {
+        const uint64_t expected = echoes.value() + 1;
+        const Clock::time_point start = Clock::now();
+
+        is::sh::mock::publish_message(out_topic, msg);
+        if (!echoes.wait_for(expected, 1s))
+        {
+            state.SkipWithError("The echo did not arrive within one second");
+            break;
+        }
+
+        const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        state.SetIterationTime(elapsed);
+        samples_us.push_back(elapsed * 1e6);
+    }
+
+    state.SetLabel(g_spin_label);
+    state.counters["p50_us"] = percentile(samples_us, 0.50);
+    state.counters["p99_us"] = percentile(samples_us, 0.99);
+    state.counters["p999_us"] = percentile(samples_us, 0.999);
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+//==============================================================================
+// Throughput of bursts of messages, which stresses the queues in both directions.
+void BM_Throughput(
+        benchmark::State& state,
+        Topic topic)
+{
+    const xtypes::DynamicData msg = make_message(topic, state.range(0));
+    const std::string out_topic = std::string(g_topic_names[topic]) + "_out";
+    const int64_t burst = state.range(1);
+    EchoCounter& echoes = g_echoes[topic];
+
+    uint64_t lost = 0;
+    for (auto _ : state)
+    {
+        const uint64_t first = echoes.value();
+        for (int64_t i = 0; i < burst; ++i)
+        {
+            is::sh::mock::publish_message(out_topic, msg);
+        }
+
+        // Whatever does not arrive in time was dropped by a full queue along the way.
+        echoes.wait_for(first + burst, 2s);
+        lost += first + burst - std::min<uint64_t>(echoes.value(), first + burst);
+    }
+
+    state.SetLabel(g_spin_label);
+    state.SetItemsProcessed(state.iterations() * burst);
+    state.SetBytesProcessed(state.iterations() * burst * state.range(0));
+    state.counters["lost"] = static_cast<double>(lost);
+}
+
+//==============================================================================
+// Cost of handing a message to the SystemHandle: the mock middleware delivers it
+// synchronously to the ROS 1 Publisher::publish of the generated mix library.
+void BM_Publish(
+        benchmark::State& state,
+        Topic topic)
+{
+    const xtypes::DynamicData msg = make_message(topic, state.range(0));
+    const std::string out_topic = std::string(g_topic_names[topic]) + "_out";
+
+    for (auto _ : state)
+    {
+        is::sh::mock::publish_message(out_topic, msg);
+    }
+
+    state.SetLabel(g_spin_label);
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+
+    // Let the echoes drain before the next benchmark.
+    g_echoes[topic].wait_for(std::numeric_limits<uint64_t>::max(), 500ms);
+}
+
+//==============================================================================
+template<typename Msg>
+ros::Subscriber echo(
+        ros::NodeHandle& node,
+        const std::string& topic_name,
+        std::vector<ros::Publisher>& publishers)
+{
+    publishers.push_back(node.advertise<Msg>(topic_name + "_in", 1000));
+    ros::Publisher& publisher = publishers.back();
+
+    return node.subscribe<Msg>(topic_name + "_out", 1000,
+                   [&publisher](const boost::shared_ptr<const Msg>& msg)
+                   {
+                       publisher.publish(msg);
+                   });
+}
+
+//==============================================================================
+int run_echo_node(
+        int argc,
+        char** argv,
+        int quit_fd)
+{
+    ros::init(argc, argv, "is_ros1_benchmark_echo", ros::init_options::AnonymousName);
+
+    {
+        ros::NodeHandle node;
+        std::vector<ros::Publisher> publishers;
+        publishers.reserve(3);
+
+        const ros::Subscriber subscribers[] = {
+            echo<geometry_msgs::Pose>(node, g_topic_names[POSE], publishers),
+            echo<std_msgs::String>(node, g_topic_names[STRING], publishers),
+            echo<sensor_msgs::Image>(node, g_topic_names[IMAGE], publishers)
+        };
+
+        ros::AsyncSpinner spinner(1);
+        spinner.start();
+
+        // The parent closes the pipe when it is done.
+        char byte;
+        while (0 < read(quit_fd, &byte, 1))
+        {
+        }
+
+        spinner.stop();
+    }
+
+    ros::shutdown();
+    return 0;
+}
+
+//==============================================================================
+bool wait_for_connections()
+{
+    for (int topic = POSE; topic <= IMAGE; ++topic)
+    {
+        const xtypes::DynamicData msg = make_message(static_cast<Topic>(topic), 16);
+        const std::string out_topic = std::string(g_topic_names[topic]) + "_out";
+
+        bool connected = false;
+        for (int attempt = 0; attempt < 100 && !connected; ++attempt)
+        {
+            is::sh::mock::publish_message(out_topic, msg);
+            connected = g_echoes[topic].wait_for(1, 100ms);
+        }
+
+        if (!connected)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//==============================================================================
+/**
+ * Build the `spin` block of the SystemHandle from the spin arguments, and remove them
+ * from argv, so that Google Benchmark does not see them. The SystemHandle polls at 10 Hz
+ * by default, which would hide any difference in a round trip, so the `poll` mode runs
+ * at 1 kHz unless `--spin-period-ms` says otherwise.
+ */
+bool parse_spin_arguments(
+        int& argc,
+        char** argv,
+        YAML::Node& spin)
+{
+    std::string mode = "event";
+    int remaining = 1;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if ("--spin" == arg && i + 1 < argc)
+        {
+            mode = argv[++i];
+        }
+        else if ("--spin-period-ms" == arg && i + 1 < argc)
+        {
+            spin["period_ms"] = std::stoul(argv[++i]);
+        }
+        else if ("--spin-threads" == arg && i + 1 < argc)
+        {
+            spin["threads"] = std::stoul(argv[++i]);
+        }
+        else
+        {
+            argv[remaining++] = argv[i];
+        }
+    }
+
+    argc = remaining;
+
+    if ("event" != mode && "poll" != mode && "async" != mode)
+    {
+        std::cerr << "Unknown spin mode '" << mode << "'. Supported modes are "
+                  << "'event', 'poll' and 'async'" << std::endl;
+        return false;
+    }
+
+    spin["mode"] = mode;
+    if ("poll" == mode && !spin["period_ms"])
+    {
+        spin["period_ms"] = 1;
+    }
+
+    g_spin_label = "spin=" + mode;
+    return true;
+}
+
+} // anonymous namespace
+
+BENCHMARK_CAPTURE(BM_RoundTrip, pose, POSE)->Arg(0)->UseManualTime();
+BENCHMARK_CAPTURE(BM_RoundTrip, string, STRING)->RangeMultiplier(16)->Range(16, 1 << 20)->UseManualTime();
+BENCHMARK_CAPTURE(BM_RoundTrip, image, IMAGE)
+->Arg(64 * 64 * 3)->Arg(640 * 480 * 3)->Arg(1920 * 1080 * 3)->UseManualTime();
+
+BENCHMARK_CAPTURE(BM_Throughput, pose, POSE)->Args({0, 100})->Args({0, 1000})->UseRealTime();
+BENCHMARK_CAPTURE(BM_Throughput, image, IMAGE)->Args({640 * 480 * 3, 100})->UseRealTime();
+
+BENCHMARK_CAPTURE(BM_Publish, pose, POSE)->Arg(0);
+BENCHMARK_CAPTURE(BM_Publish, image, IMAGE)->Arg(640 * 480 * 3)->Arg(1920 * 1080 * 3);
+
+int main(
+        int argc,
+        char** argv)
+{
+    YAML::Node spin;
+    if (!parse_spin_arguments(argc, argv, spin))
+    {
+        return 1;
+    }
+
+    YAML::Node config = YAML::LoadFile(ROS1__BRIDGE__BENCHMARK_CONFIG);
+    config["systems"]["ros1"]["spin"] = spin;
+
+    int quit_pipe[2];
+    if (0 != pipe(quit_pipe))
+    {
+        return 1;
+    }
+
+    const pid_t pid = fork();
+    if (0 > pid)
+    {
+        return 1;
+    }
+    else if (0 == pid)
+    {
+        close(quit_pipe[1]);
+        _exit(run_echo_node(argc, argv, quit_pipe[0]));
+    }
+
+    close(quit_pipe[0]);
+
+    benchmark::Initialize(&argc, argv);
+
+    // We add the build directory that any unfound mix packages may have been
+    // built in, so that they can be found by the application.
+    g_handle = std::make_unique<is::core::InstanceHandle>(is::run_instance(
+                        config, {ROS1__GENMSG__BUILD_DIR}));
+
+    int result = 1;
+    if (*g_handle)
+    {
+        for (int topic = POSE; topic <= IMAGE; ++topic)
+        {
+            EchoCounter& counter = g_echoes[topic];
+            is::sh::mock::subscribe(
+                std::string(g_topic_names[topic]) + "_in",
+                [&counter](const xtypes::DynamicData&)
+                {
+                    counter.notify();
+                });
+        }
+
+        if (wait_for_connections())
+        {
+            benchmark::RunSpecifiedBenchmarks();
+            result = 0;
+        }
+
+        g_handle->quit().wait_for(5s);
+    }
+
+    close(quit_pipe[1]);
+    waitpid(pid, nullptr, 0);
+
+    return result;
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2020 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <is/genmsg/ros1/geometry_msgs/msg/convert__msg__PoseStamped.hpp>
+#include <is/genmsg/ros1/sensor_msgs/msg/convert__msg__Image.hpp>
+#include <is/genmsg/ros1/sensor_msgs/msg/convert__msg__PointCloud2.hpp>
+#include <is/genmsg/ros1/std_msgs/msg/convert__msg__String.hpp>
+
+#include <benchmark/benchmark.h>
+
+namespace ros1 = eprosima::is::sh::ros1;
+namespace xtypes = eprosima::xtypes;
+
+namespace {
+
+//==============================================================================
+geometry_msgs::PoseStamped make_message(
+        geometry_msgs::PoseStamped*,
+        std::size_t /*payload_size*/)
+{
+    geometry_msgs::PoseStamped msg;
+    msg.header.seq = 1;
+    msg.header.stamp.sec = 266;
+    msg.header.stamp.nsec = 267;
+    msg.header.frame_id = "map";
+    msg.pose.position.x = 1.0;
+    msg.pose.position.y = 2.0;
+    msg.pose.position.z = 3.0;
+    msg.pose.orientation.w = 1.0;
+    return msg;
+}
+
+//==============================================================================
+std_msgs::String make_message(
+        std_msgs::String*,
+        std::size_t payload_size)
+{
+    std_msgs::String msg;
+    msg.data.assign(payload_size, 'x');
+    return msg;
+}
+
+//==============================================================================
+sensor_msgs::Image make_message(
+        sensor_msgs::Image*,
+        std::size_t payload_size)
+{
+    // A row-major rgb8 image, as wide as possible for the requested payload.
+    sensor_msgs::Image msg;
+    msg.header.frame_id = "camera";
+    msg.encoding = "rgb8";
+    msg.height = 1;
+    msg.width = static_cast<uint32_t>(payload_size / 3);
+    msg.step = msg.width * 3;
+    msg.data.assign(payload_size, 0x7f);
+    return msg;
+}
+
+//==============================================================================
+sensor_msgs::PointCloud2 make_message(
+        sensor_msgs::PointCloud2*,
+        std::size_t payload_size)
+{
+    // An unorganized cloud of float32 x, y, z points.
+    sensor_msgs::PointCloud2 msg;
+    msg.header.frame_id = "lidar";
+    msg.fields.resize(3);
+    const char* names[] = {"x", "y", "z"};
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        msg.fields[i].name = names[i];
+        msg.fields[i].offset = 4 * i;
+        msg.fields[i].datatype = sensor_msgs::PointField::FLOAT32;
+        msg.fields[i].count = 1;
+    }
+    msg.point_step = 12;
+    msg.height = 1;
+    msg.width = static_cast<uint32_t>(payload_size / msg.point_step);
+    msg.row_step = msg.width * msg.point_step;
+    msg.is_dense = true;
+    msg.data.assign(payload_size, 0x3f);
+    return msg;
+}
+
+//==============================================================================
+template<typename Msg, typename Convert>
+void BM_ConvertToXType(
+        benchmark::State& state)
+{
+    const Msg msg = make_message(static_cast<Msg*>(nullptr), state.range(0));
+    xtypes::DynamicData data(Convert::type());
+
+    for (auto _ : state)
+    {
+        Convert::convert_to_xtype(msg, data);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.iterations() * ros::serialization::serializationLength(msg));
+}
+
+//==============================================================================
+template<typename Msg, typename Convert>
+void BM_ConvertToRos1(
+        benchmark::State& state)
+{
+    const Msg original = make_message(static_cast<Msg*>(nullptr), state.range(0));
+    xtypes::DynamicData data(Convert::type());
+    Convert::convert_to_xtype(original, data);
+
+    Msg msg;
+    for (auto _ : state)
+    {
+        Convert::convert_to_ros1(data, msg);
+        benchmark::DoNotOptimize(msg);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.iterations() * ros::serialization::serializationLength(original));
+}
+
+//==============================================================================
+// Unlike the loops above, which reuse their destination message as the bridge does,
+// this one measures the conversion into a fresh instance, that is, the cost of a
+// converter whose destination does not keep its allocations.
+template<typename Msg, typename Convert>
+void BM_ConvertToXTypeFresh(
+        benchmark::State& state)
+{
+    const Msg msg = make_message(static_cast<Msg*>(nullptr), state.range(0));
+    const xtypes::StructType& type = Convert::type();
+
+    for (auto _ : state)
+    {
+        xtypes::DynamicData data(type);
+        Convert::convert_to_xtype(msg, data);
+        benchmark::DoNotOptimize(data);
+    }
+
+    state.SetBytesProcessed(state.iterations() * ros::serialization::serializationLength(msg));
+}
+
+using PoseStamped = ros1::convert__geometry_msgs__msg__PoseStamped;
+using String = ros1::convert__std_msgs__msg__String;
+using Image = ros1::convert__sensor_msgs__msg__Image;
+using PointCloud2 = ros1::convert__sensor_msgs__msg__PointCloud2;
+
+} // anonymous namespace
+
+BENCHMARK_TEMPLATE(BM_ConvertToXType, geometry_msgs::PoseStamped, PoseStamped)->Arg(0);
+BENCHMARK_TEMPLATE(BM_ConvertToRos1, geometry_msgs::PoseStamped, PoseStamped)->Arg(0);
+
+BENCHMARK_TEMPLATE(BM_ConvertToXType, std_msgs::String, String)->RangeMultiplier(16)->Range(16, 1 << 20);
+BENCHMARK_TEMPLATE(BM_ConvertToRos1, std_msgs::String, String)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+// From a 64x64 thumbnail up to a 1920x1080 rgb8 frame.
+BENCHMARK_TEMPLATE(BM_ConvertToXType, sensor_msgs::Image, Image)
+->Arg(64 * 64 * 3)->Arg(640 * 480 * 3)->Arg(1920 * 1080 * 3);
+BENCHMARK_TEMPLATE(BM_ConvertToRos1, sensor_msgs::Image, Image)
+->Arg(64 * 64 * 3)->Arg(640 * 480 * 3)->Arg(1920 * 1080 * 3);
+BENCHMARK_TEMPLATE(BM_ConvertToXTypeFresh, sensor_msgs::Image, Image)
+->Arg(64 * 64 * 3)->Arg(640 * 480 * 3)->Arg(1920 * 1080 * 3);
+
+// From 1k to 128k points.
+BENCHMARK_TEMPLATE(BM_ConvertToXType, sensor_msgs::PointCloud2, PointCloud2)
+->RangeMultiplier(8)->Range(12 * 1024, 12 * 128 * 1024);
+BENCHMARK_TEMPLATE(BM_ConvertToRos1, sensor_msgs::PointCloud2, PointCloud2)
+->RangeMultiplier(8)->Range(12 * 1024, 12 * 128 * 1024);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,760 @@
+/*
+ * Copyright (C) 2020 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/**
+ * Record-and-replay load generator for the ROS 1 SystemHandle.
+ *
+ * The `record` command captures the traffic of a set of ROS 1 topics, as it is, into a capture file:
+ * the topic, the ROS 1 type, the receipt time and the serialized bytes of every message.
+ *
+ * The `replay` command runs an Integration Service instance from a bridge configuration that routes
+ * the captured topics from a `ros1` system to a `mock` system, while a child process, which is a plain
+ * ROS 1 node, publishes the captured messages from a memory mapping of the capture file, following
+ * their original timing, a multiple of it, or as fast as possible. Every message reaching the mock
+ * middleware is matched with its publication, and a report of the latency, throughput and drops of
+ * each topic is printed once the replay ends, leaving the latency out for the topics with drops.
+ * The replay can thus be run against several builds or configurations of the bridge, such as with
+ * other spinning modes, delivery modes or passthrough topics.
+ */
+
+#include <is/sh/mock/api.hpp>
+#include <is/core/Instance.hpp>
+
+#include <ros/node_handle.h>
+#include <ros/serialization.h>
+#include <topic_tools/shape_shifter.h>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <yaml-cpp/yaml.h>
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace is = eprosima::is;
+namespace xtypes = eprosima::xtypes;
+
+using namespace std::chrono_literals;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+//==============================================================================
+// Capture file format, in the byte order of the recording host:
+// the `magic` string, followed by records, each of them made of a RecordHeader and its payload.
+// The payload of a TOPIC record holds the name, datatype, md5sum and message definition of the
+// topic, each of them prefixed by its uint32_t length, and the one of a MESSAGE record holds the
+// serialized message.
+const char g_magic[8] = {'I', 'S', 'R', 'O', 'S', '1', 'C', '1'};
+
+enum RecordKind : uint32_t
+{
+    TOPIC = 1,
+    MESSAGE = 2
+};
+
+struct RecordHeader
+{
+    uint32_t kind;
+    uint32_t topic;
+    uint64_t time_ns;
+    uint32_t size;
+    uint32_t reserved;
+};
+
+struct CapturedTopic
+{
+    std::string name;
+    std::string datatype;
+    std::string md5sum;
+    std::string definition;
+};
+
+struct CapturedMessage
+{
+    uint32_t topic;
+    uint64_t time_ns;
+    const uint8_t* data;
+    uint32_t size;
+};
+
+//==============================================================================
+void write_string(
+        std::ostream& out,
+        const std::string& value)
+{
+    const uint32_t length = static_cast<uint32_t>(value.size());
+    out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    out.write(value.data(), length);
+}
+
+//==============================================================================
+bool read_string(
+        const uint8_t*& cursor,
+        const uint8_t* end,
+        std::string& value)
+{
+    uint32_t length;
+    if (end - cursor < static_cast<std::ptrdiff_t>(sizeof(length)))
+    {
+        return false;
+    }
+
+    std::memcpy(&length, cursor, sizeof(length));
+    cursor += sizeof(length);
+    if (end - cursor < static_cast<std::ptrdiff_t>(length))
+    {
+        return false;
+    }
+
+    value.assign(reinterpret_cast<const char*>(cursor), length);
+    cursor += length;
+    return true;
+}
+
+//==============================================================================
+/**
+ * Writes the messages of the recorded topics to a capture file, as they arrive.
+ * They are all received from the same spinning thread.
+ */
+class Recorder
+{
+public:
+
+    Recorder(
+            const std::string& path)
+        : _out(path, std::ios::binary | std::ios::trunc)
+        , _start(Clock::now())
+    {
+        _out.write(g_magic, sizeof(g_magic));
+    }
+
+    bool good() const
+    {
+        return _out.good();
+    }
+
+    void subscribe(
+            ros::NodeHandle& node,
+            const std::string& topic_name)
+    {
+        const uint32_t topic = static_cast<uint32_t>(_declared.size());
+        _declared.push_back(false);
+
+        _subscribers.push_back(node.subscribe<topic_tools::ShapeShifter>(
+                    topic_name, 1000,
+                    [this, topic, topic_name](const boost::shared_ptr<const topic_tools::ShapeShifter>& msg)
+                    {
+                        record(topic, topic_name, *msg);
+                    }));
+    }
+
+    uint64_t messages() const
+    {
+        return _messages;
+    }
+
+private:
+
+    void record(
+            uint32_t topic,
+            const std::string& topic_name,
+            const topic_tools::ShapeShifter& msg)
+    {
+        const uint64_t time_ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - _start).count());
+
+        // The type of a topic is only known once its first message arrives.
+        if (!_declared[topic])
+        {
+            std::ostringstream payload;
+            write_string(payload, topic_name);
+            write_string(payload, msg.getDataType());
+            write_string(payload, msg.getMD5Sum());
+            write_string(payload, msg.getMessageDefinition());
+
+            const std::string bytes = payload.str();
+            write_header(TOPIC, topic, time_ns, static_cast<uint32_t>(bytes.size()));
+            _out.write(bytes.data(), bytes.size());
+            _declared[topic] = true;
+        }
+
+        const uint32_t size = msg.size();
+        _buffer.resize(size);
+        ros::serialization::OStream stream(_buffer.data(), size);
+        msg.write(stream);
+
+        write_header(MESSAGE, topic, time_ns, size);
+        _out.write(reinterpret_cast<const char*>(_buffer.data()), size);
+        ++_messages;
+    }
+
+    void write_header(
+            RecordKind kind,
+            uint32_t topic,
+            uint64_t time_ns,
+            uint32_t size)
+    {
+        const RecordHeader header{kind, topic, time_ns, size, 0};
+        _out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+
+    std::ofstream _out;
+    const Clock::time_point _start;
+    std::vector<bool> _declared;
+    std::vector<ros::Subscriber> _subscribers;
+    std::vector<uint8_t> _buffer;
+    uint64_t _messages = 0;
+};
+
+//==============================================================================
+/**
+ * A capture file, mapped in memory. The messages point into the mapping.
+ */
+class Capture
+{
+public:
+
+    bool open(
+            const std::string& path)
+    {
+        try
+        {
+            _file = boost::interprocess::file_mapping(path.c_str(), boost::interprocess::read_only);
+            _region = boost::interprocess::mapped_region(_file, boost::interprocess::read_only);
+        }
+        catch (const boost::interprocess::interprocess_exception& e)
+        {
+            std::cerr << "Failed to map the capture file '" << path << "': " << e.what() << std::endl;
+            return false;
+        }
+
+        const uint8_t* cursor = static_cast<const uint8_t*>(_region.get_address());
+        const uint8_t* const end = cursor + _region.get_size();
+
+        if (end - cursor < static_cast<std::ptrdiff_t>(sizeof(g_magic))
+                || 0 != std::memcmp(cursor, g_magic, sizeof(g_magic)))
+        {
+            std::cerr << "'" << path << "' is not a capture file" << std::endl;
+            return false;
+        }
+        cursor += sizeof(g_magic);
+
+        std::map<uint32_t, std::size_t> topic_index;
+        while (end - cursor >= static_cast<std::ptrdiff_t>(sizeof(RecordHeader)))
+        {
+            RecordHeader header;
+            std::memcpy(&header, cursor, sizeof(header));
+            cursor += sizeof(header);
+
+            if (end - cursor < static_cast<std::ptrdiff_t>(header.size))
+            {
+                // A recording that was interrupted may end with a partial record.
+                std::cerr << "Ignoring the truncated record at the end of '" << path << "'" << std::endl;
+                break;
+            }
+
+            const uint8_t* const payload = cursor;
+            cursor += header.size;
+
+            if (TOPIC == header.kind)
+            {
+                CapturedTopic topic;
+                const uint8_t* field = payload;
+                if (!read_string(field, cursor, topic.name)
+                        || !read_string(field, cursor, topic.datatype)
+                        || !read_string(field, cursor, topic.md5sum)
+                        || !read_string(field, cursor, topic.definition))
+                {
+                    std::cerr << "Malformed topic record in '" << path << "'" << std::endl;
+                    return false;
+                }
+
+                topic_index[header.topic] = topics.size();
+                topics.emplace_back(std::move(topic));
+            }
+            else if (MESSAGE == header.kind)
+            {
+                const auto it = topic_index.find(header.topic);
+                if (it == topic_index.end())
+                {
+                    std::cerr << "Message record of an undeclared topic in '" << path << "'" << std::endl;
+                    return false;
+                }
+
+                messages.push_back(CapturedMessage{
+                                static_cast<uint32_t>(it->second), header.time_ns, payload, header.size});
+            }
+        }
+
+        return !messages.empty();
+    }
+
+    std::vector<CapturedTopic> topics;
+    std::vector<CapturedMessage> messages;
+
+private:
+
+    boost::interprocess::file_mapping _file;
+    boost::interprocess::mapped_region _region;
+};
+
+//==============================================================================
+/**
+ * The publication times of the replayed messages, shared with the player process.
+ */
+struct SharedTimes
+{
+    explicit SharedTimes(
+            std::size_t count)
+        : size(count * sizeof(std::atomic<uint64_t>))
+    {
+        void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        times = (MAP_FAILED == address) ? nullptr : static_cast<std::atomic<uint64_t>*>(address);
+    }
+
+    ~SharedTimes()
+    {
+        if (times)
+        {
+            munmap(times, size);
+        }
+    }
+
+    const std::size_t size;
+    std::atomic<uint64_t>* times;
+};
+
+uint64_t now_ns()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+               Clock::now().time_since_epoch()).count());
+}
+
+//==============================================================================
+/**
+ * Publish the captured messages, following their original timing divided by the rate.
+ * A rate of zero publishes them as fast as possible.
+ */
+void play(
+        const Capture& capture,
+        double rate,
+        std::vector<topic_tools::ShapeShifter>& shape_shifters,
+        std::vector<ros::Publisher>& publishers,
+        std::atomic<uint64_t>* times)
+{
+    // Do not start until the bridge subscribed to every topic.
+    const Clock::time_point deadline = Clock::now() + 10s;
+    while (Clock::now() < deadline && std::any_of(publishers.begin(), publishers.end(),
+            [](const ros::Publisher& publisher)
+            {
+                return 0 == publisher.getNumSubscribers();
+            }))
+    {
+        std::this_thread::sleep_for(50ms);
+    }
+
+    const Clock::time_point start = Clock::now();
+    const uint64_t first_ns = capture.messages.front().time_ns;
+
+    for (std::size_t i = 0; i < capture.messages.size() && ros::ok(); ++i)
+    {
+        const CapturedMessage& message = capture.messages[i];
+        if (0.0 < rate)
+        {
+            std::this_thread::sleep_until(start + std::chrono::nanoseconds(
+                    static_cast<int64_t>((message.time_ns - first_ns) / rate)));
+        }
+
+        topic_tools::ShapeShifter& shape_shifter = shape_shifters[message.topic];
+        ros::serialization::IStream stream(const_cast<uint8_t*>(message.data), message.size);
+        shape_shifter.read(stream);
+
+        times[i].store(now_ns(), std::memory_order_release);
+        publishers[message.topic].publish(shape_shifter);
+    }
+
+    // Let roscpp flush the outgoing queues.
+    std::this_thread::sleep_for(500ms);
+}
+
+//==============================================================================
+/**
+ * The player process: a plain ROS 1 node publishing the captured messages.
+ * It starts once the parent, which runs the bridge, writes to the start pipe,
+ * and gives up if it is closed instead.
+ */
+int run_player(
+        int argc,
+        char** argv,
+        const Capture& capture,
+        double rate,
+        std::atomic<uint64_t>* times,
+        int start_fd)
+{
+    ros::init(argc, argv, "is_ros1_load_generator_player", ros::init_options::AnonymousName);
+
+    int result = 0;
+    {
+        ros::NodeHandle node;
+
+        std::vector<topic_tools::ShapeShifter> shape_shifters(capture.topics.size());
+        std::vector<ros::Publisher> publishers;
+        for (std::size_t i = 0; i < capture.topics.size(); ++i)
+        {
+            const CapturedTopic& topic = capture.topics[i];
+            shape_shifters[i].morph(topic.md5sum, topic.datatype, topic.definition, "");
+            publishers.push_back(shape_shifters[i].advertise(node, topic.name, 1000));
+        }
+
+        char byte;
+        if (1 == read(start_fd, &byte, 1))
+        {
+            play(capture, rate, shape_shifters, publishers, times);
+        }
+        else
+        {
+            // The bridge did not start, but the node still has to leave the ROS 1 graph.
+            result = 1;
+        }
+    }
+
+    ros::shutdown();
+    return result;
+}
+
+//==============================================================================
+/**
+ * The statistics of a replayed topic, as seen by the mock middleware.
+ * The messages of a topic are matched with their publications in order, since the
+ * mock middleware receives them as opaque DynamicData, so a single drop shifts every
+ * later match. The latencies of the topics that dropped messages are not reported.
+ */
+struct TopicReport
+{
+    std::vector<std::size_t> messages;
+    std::size_t received = 0;
+    uint64_t bytes = 0;
+    uint64_t first_receipt_ns = 0;
+    uint64_t last_receipt_ns = 0;
+    std::vector<double> latencies_us;
+};
+
+double percentile(
+        std::vector<double>& samples,
+        double ratio)
+{
+    if (samples.empty())
+    {
+        return 0.0;
+    }
+
+    const std::size_t index = std::min(
+        samples.size() - 1, static_cast<std::size_t>(ratio * samples.size()));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+//==============================================================================
+int replay(
+        int argc,
+        char** argv,
+        const std::string& capture_path,
+        const std::string& config_path,
+        double rate,
+        const std::vector<std::string>& mix_paths,
+        std::chrono::milliseconds drain)
+{
+    Capture capture;
+    if (!capture.open(capture_path))
+    {
+        return 1;
+    }
+
+    SharedTimes shared_times(capture.messages.size());
+    if (!shared_times.times)
+    {
+        std::cerr << "Failed to allocate the shared publication times" << std::endl;
+        return 1;
+    }
+
+    std::vector<TopicReport> reports(capture.topics.size());
+    for (std::size_t i = 0; i < capture.messages.size(); ++i)
+    {
+        TopicReport& report = reports[capture.messages[i].topic];
+        report.messages.push_back(i);
+        report.bytes += capture.messages[i].size;
+    }
+
+    // The player is forked before the bridge starts any thread or initializes roscpp.
+    int start_pipe[2];
+    if (0 != pipe(start_pipe))
+    {
+        return 1;
+    }
+
+    const pid_t pid = fork();
+    if (0 > pid)
+    {
+        return 1;
+    }
+    else if (0 == pid)
+    {
+        close(start_pipe[1]);
+        _exit(run_player(argc, argv, capture, rate, shared_times.times, start_pipe[0]));
+    }
+
+    close(start_pipe[0]);
+
+    is::core::InstanceHandle handle = is::run_instance(YAML::LoadFile(config_path), mix_paths);
+    if (!handle)
+    {
+        std::cerr << "Failed to start the bridge from '" << config_path << "'" << std::endl;
+        close(start_pipe[1]);
+        waitpid(pid, nullptr, 0);
+        return 1;
+    }
+
+    std::mutex mutex;
+    for (std::size_t topic = 0; topic < capture.topics.size(); ++topic)
+    {
+        TopicReport& report = reports[topic];
+        is::sh::mock::subscribe(
+            capture.topics[topic].name,
+            [&report, &mutex, &shared_times](const xtypes::DynamicData&)
+            {
+                const uint64_t receipt_ns = now_ns();
+
+                std::unique_lock<std::mutex> lock(mutex);
+                if (report.received < report.messages.size())
+                {
+                    const uint64_t sent_ns = shared_times.times[report.messages[report.received]]
+                            .load(std::memory_order_acquire);
+                    if (0 < sent_ns && sent_ns <= receipt_ns)
+                    {
+                        report.latencies_us.push_back((receipt_ns - sent_ns) / 1000.0);
+                    }
+                }
+
+                if (0 == report.received)
+                {
+                    report.first_receipt_ns = receipt_ns;
+                }
+                report.last_receipt_ns = receipt_ns;
+                ++report.received;
+            });
+    }
+
+    const char start = 1;
+    const bool started = 1 == write(start_pipe[1], &start, 1);
+    close(start_pipe[1]);
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    std::this_thread::sleep_for(drain);
+
+    handle.quit().wait_for(5s);
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    std::cout << std::left << std::setw(32) << "topic"
+              << std::right << std::setw(10) << "sent" << std::setw(10) << "received"
+              << std::setw(10) << "dropped" << std::setw(12) << "msgs/s" << std::setw(12) << "MB/s"
+              << std::setw(10) << "p50_us" << std::setw(10) << "p99_us" << std::setw(10) << "p999_us"
+              << std::setw(10) << "max_us" << std::endl;
+
+    for (std::size_t topic = 0; topic < capture.topics.size(); ++topic)
+    {
+        TopicReport& report = reports[topic];
+        const std::size_t sent = report.messages.size();
+        const std::size_t received = std::min(report.received, sent);
+        const double seconds = (report.last_receipt_ns - report.first_receipt_ns) / 1e9;
+        const double throughput = seconds > 0.0 ? received / seconds : 0.0;
+        const double bandwidth = seconds > 0.0 && 0 < sent
+                ? (report.bytes * (static_cast<double>(received) / sent)) / seconds / 1e6 : 0.0;
+
+        std::cout << std::left << std::setw(32) << capture.topics[topic].name
+                  << std::right << std::setw(10) << sent << std::setw(10) << received
+                  << std::setw(10) << sent - received
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(12) << throughput << std::setw(12) << bandwidth;
+
+        if (report.received != sent || report.latencies_us.empty())
+        {
+            std::cout << std::setw(10) << "-" << std::setw(10) << "-"
+                      << std::setw(10) << "-" << std::setw(10) << "-" << std::endl;
+            continue;
+        }
+
+        const double max = *std::max_element(report.latencies_us.begin(), report.latencies_us.end());
+        std::cout << std::setw(10) << percentile(report.latencies_us, 0.50)
+                  << std::setw(10) << percentile(report.latencies_us, 0.99)
+                  << std::setw(10) << percentile(report.latencies_us, 0.999)
+                  << std::setw(10) << max << std::endl;
+    }
+
+    return started && WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
+
+//==============================================================================
+int record(
+        int argc,
+        char** argv,
+        const std::string& capture_path,
+        const std::vector<std::string>& topics,
+        std::chrono::seconds duration)
+{
+    ros::init(argc, argv, "is_ros1_load_generator_recorder", ros::init_options::AnonymousName);
+
+    uint64_t messages = 0;
+    {
+        ros::NodeHandle node;
+        Recorder recorder(capture_path);
+        if (!recorder.good())
+        {
+            std::cerr << "Failed to open the capture file '" << capture_path << "'" << std::endl;
+            return 1;
+        }
+
+        for (const std::string& topic : topics)
+        {
+            recorder.subscribe(node, topic);
+        }
+
+        const Clock::time_point deadline = Clock::now() + duration;
+        while (ros::ok() && (0 == duration.count() || Clock::now() < deadline))
+        {
+            ros::spinOnce();
+            std::this_thread::sleep_for(1ms);
+        }
+
+        messages = recorder.messages();
+    }
+
+    std::cout << "Recorded " << messages << " messages into '" << capture_path << "'" << std::endl;
+
+    ros::shutdown();
+    return 0;
+}
+
+//==============================================================================
+int usage(
+        const char* program)
+{
+    std::cerr << "Usage:" << std::endl
+              << "  " << program << " record <capture file> <topic>... [--duration <s>]" << std::endl
+              << "  " << program << " replay <capture file> <bridge configuration>"
+              << " [--rate <multiple> | --max-rate] [--mix-path <dir>]... [--drain-ms <ms>]" << std::endl;
+    return 1;
+}
+
+} // anonymous namespace
+
+int main(
+        int argc,
+        char** argv)
+{
+    if (argc < 4)
+    {
+        return usage(argv[0]);
+    }
+
+    const std::string command = argv[1];
+    const std::string capture_path = argv[2];
+
+    // The remapping arguments, such as __master:=, are left for roscpp.
+    if ("record" == command)
+    {
+        std::vector<std::string> topics;
+        std::chrono::seconds duration(0);
+        for (int i = 3; i < argc; ++i)
+        {
+            const std::string arg = argv[i];
+            if ("--duration" == arg && i + 1 < argc)
+            {
+                duration = std::chrono::seconds(std::stoul(argv[++i]));
+            }
+            else if (std::string::npos == arg.find(":="))
+            {
+                topics.push_back(arg);
+            }
+        }
+
+        return record(argc, argv, capture_path, topics, duration);
+    }
+    else if ("replay" == command)
+    {
+        const std::string config_path = argv[3];
+        double rate = 1.0;
+
+        // The mix libraries built along with the benchmarks are found without further ado.
+        std::vector<std::string> mix_paths{ROS1__GENMSG__BUILD_DIR};
+        std::chrono::milliseconds drain(2000);
+        for (int i = 4; i < argc; ++i)
+        {
+            const std::string arg = argv[i];
+            if ("--rate" == arg && i + 1 < argc)
+            {
+                rate = std::stod(argv[++i]);
+                if (rate <= 0.0)
+                {
+                    return usage(argv[0]);
+                }
+            }
+            else if ("--max-rate" == arg)
+            {
+                rate = 0.0;
+            }
+            else if ("--mix-path" == arg && i + 1 < argc)
+            {
+                mix_paths.emplace_back(argv[++i]);
+            }
+            else if ("--drain-ms" == arg && i + 1 < argc)
+            {
+                drain = std::chrono::milliseconds(std::stoul(argv[++i]));
+            }
+            else if (std::string::npos != arg.find(":="))
+            {
+                // A roscpp remapping argument.
+            }
+            else
+            {
+                return usage(argv[0]);
+            }
+        }
+
+        return replay(argc, argv, capture_path, config_path, rate, mix_paths, drain);
+    }
+
+    return usage(argv[0]);
+}
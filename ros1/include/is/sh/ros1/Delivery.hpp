@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2020 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _IS_SH_ROS1__INCLUDE__DELIVERY_HPP_
+#define _IS_SH_ROS1__INCLUDE__DELIVERY_HPP_
+
+#include <is/sh/ros1/TopicOptions.hpp>
+
+#include <ros/forwards.h>
+#include <ros/wall_timer.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace ros1 {
+
+/**
+ * @class DeliveryBuffer
+ * @brief Holds the messages of a topic back, according to its DeliveryOptions,
+ *        and hands them over to a single handler.
+ *
+ * @details The messages are held as shared pointers to immutable ROS 1 messages,
+ *          so holding them back copies nothing, and in `latest` mode the messages
+ *          that get superseded are never converted at all. They are type erased,
+ *          so that a single implementation serves every message type, and the
+ *          handler casts them back to the type it pushed.
+ *
+ *          The period is driven by a ros::WallTimer served by the callback queue of the
+ *          given node, so that the handler runs in the same threads as the rest of the
+ *          callbacks of the topic. Messages are always handed over in arrival order,
+ *          and never concurrently, even if that queue is served by several threads.
+ */
+class DeliveryBuffer
+{
+public:
+
+    using MsgConstPtr = boost::shared_ptr<const void>;
+
+    using Handler = std::function<void (const MsgConstPtr&)>;
+
+    DeliveryBuffer(
+            ros::NodeHandle& node,
+            const DeliveryOptions& options,
+            Handler handler);
+
+    ~DeliveryBuffer();
+
+    /**
+     * @brief Hand over a message, or hold it back until the next delivery.
+     *
+     * @param[in] msg The received message.
+     */
+    void push(
+            const MsgConstPtr& msg);
+
+    /**
+     * @brief Hand over every message held back.
+     */
+    void flush();
+
+private:
+
+    void on_timer(
+            const ros::WallTimerEvent& event);
+
+    const DeliveryOptions _options;
+
+    const Handler _handler;
+
+    std::mutex _pending_mutex;
+    std::vector<MsgConstPtr> _pending;
+
+    std::mutex _delivery_mutex;
+    std::vector<MsgConstPtr> _delivering;
+
+    ros::WallTimer _timer;
+};
+
+} //  namespace ros1
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
+
+#endif //  _IS_SH_ROS1__INCLUDE__DELIVERY_HPP_
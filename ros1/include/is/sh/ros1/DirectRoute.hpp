@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2020 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _IS_SH_ROS1__INCLUDE__DIRECTROUTE_HPP_
+#define _IS_SH_ROS1__INCLUDE__DIRECTROUTE_HPP_
+
+#include <xtypes/xtypes.hpp>
+
+#include <cstdint>
+#include <typeinfo>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace ros1 {
+
+/**
+ * @struct DirectSource
+ * @brief The ROS 1 message a DynamicData instance was converted from,
+ *        while it is being handed over to *Integration Service*.
+ */
+struct DirectSource
+{
+    const xtypes::DynamicData* data = nullptr;
+    const void* message = nullptr;
+    const std::type_info* type = nullptr;
+
+    /// Tells apart the successive messages handed over from a same DynamicData instance.
+    uint64_t sequence = 0;
+};
+
+/**
+ * @brief Get the DirectSource of the calling thread.
+ *
+ * @details It is shared by every *mix* library, so that a publisher
+ *          can recognize the messages of a subscription of another library.
+ */
+inline DirectSource& current_direct_source()
+{
+    static thread_local DirectSource source;
+    return source;
+}
+
+/**
+ * @brief Get a new DirectSource sequence number for the calling thread.
+ */
+inline uint64_t next_direct_source_sequence()
+{
+    static thread_local uint64_t sequence = 0;
+    return ++sequence;
+}
+
+/**
+ * @class DirectSourceScope
+ * @brief Tells the ROS 1 publishers which ROS 1 message a DynamicData was converted from,
+ *        for as long as the subscription hands it over to *Integration Service*.
+ *
+ * @details *Integration Service* hands the very same DynamicData instance over to the
+ *          publishers of the routes whose types match, from within the subscription callback.
+ *          So a ROS 1 publisher of the same ROS 1 type that receives it can publish the original
+ *          ROS 1 message, as is, instead of converting the DynamicData back, which avoids the
+ *          whole conversion of the routes between two ROS 1 systems, such as two ROS 1 masters.
+ */
+class DirectSourceScope
+{
+public:
+
+    template<typename Msg>
+    DirectSourceScope(
+            const xtypes::DynamicData& data,
+            const Msg& message)
+        : _previous(current_direct_source())
+    {
+        current_direct_source() = DirectSource{&data, &message, &typeid(Msg), next_direct_source_sequence()};
+    }
+
+    ~DirectSourceScope()
+    {
+        current_direct_source() = _previous;
+    }
+
+    DirectSourceScope(
+            const DirectSourceScope&) = delete;
+
+    DirectSourceScope& operator =(
+            const DirectSourceScope&) = delete;
+
+private:
+
+    const DirectSource _previous;
+};
+
+/**
+ * @brief Get the ROS 1 message a DynamicData was converted from, if it is still
+ *        being handed over and has the requested type.
+ *
+ * @param[in] data The DynamicData received by a publisher.
+ *
+ * @returns The original ROS 1 message, or `nullptr` if it is not available.
+ */
+template<typename Msg>
+const Msg* direct_source(
+        const xtypes::DynamicData& data)
+{
+    const DirectSource& source = current_direct_source();
+    if (source.data != &data || nullptr == source.type || *source.type != typeid(Msg))
+    {
+        return nullptr;
+    }
+
+    return static_cast<const Msg*>(source.message);
+}
+
+} //  namespace ros1
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
+
+#endif //  _IS_SH_ROS1__INCLUDE__DIRECTROUTE_HPP_
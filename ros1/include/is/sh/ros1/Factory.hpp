@@ -20,9 +20,12 @@
 
 #include <is/systemhandle/SystemHandle.hpp>
 
+#include <is/sh/ros1/TopicOptions.hpp>
+
 #include <ros/node_handle.h>
 
 #include <functional>
+#include <limits>
 #include <memory>
 
 namespace eprosima {
@@ -62,6 +65,32 @@ public:
      */
     static Factory& instance();
 
+    /**
+     * @brief Interned handle of a type name within the Factory.
+     *
+     * @details It is returned when registering any builder for the type name, and it allows
+     *          to look up the builders of that type without hashing its name again.
+     *          Lookups by handle take no lock, so they are safe to perform concurrently
+     *          with other lookups and registrations.
+     */
+    using TypeId = uint32_t;
+
+    /**
+     * @brief The handle of a type name with no builder registered in the Factory.
+     */
+    static constexpr TypeId invalid_type_id = std::numeric_limits<TypeId>::max();
+
+    /**
+     * @brief Get the interned handle of a type name.
+     *
+     * @param[in] type_name The name of the type.
+     *
+     * @returns The handle of the type, or `invalid_type_id` if no builder
+     *          was registered for this type name.
+     */
+    TypeId type_id(
+            const std::string& type_name) const;
+
     /**
      * @brief Signature for the method that will be used to register a dynamic type
      *        within the types factory.
@@ -75,8 +104,10 @@ public:
      * @param[in] type_name The type name, used as key in the Factory types map.
      *
      * @param[in] register_type_func The function used to create the type.
+     *
+     * @returns The interned handle of the type name.
      */
-    void register_type_factory(
+    TypeId register_type_factory(
             const std::string& type_name,
             RegisterTypeToFactory register_type_func);
 
@@ -84,6 +115,9 @@ public:
      * @brief Create a dynamic type instance using the types registered previously
      *        in the Factory.
      *
+     * @details The type is built the first time it is requested, and the same instance
+     *          is returned from then on.
+     *
      * @param[in] type_name The name of the type to be created.
      *
      * @returns A pointer to the created type, or `nullptr` if the type was not
@@ -115,7 +149,8 @@ public:
                         const xtypes::DynamicType& message_type,
                         TopicSubscriberSystem::SubscriptionCallback* callback,
                         uint32_t queue_size,
-                        const ros::TransportHints& transport_hints)>;
+                        const ros::TransportHints& transport_hints,
+                        const TopicOptions& options)>;
 
     /**
      * @brief Register a ROS 1 subscription builder within the Factory.
@@ -123,8 +158,10 @@ public:
      * @param[in] topic_type The name of the topic type, used to index the subscription factory map.
      *
      * @param[in] register_sub_func The function used to create the subscription.
+     *
+     * @returns The interned handle of the type name.
      */
-    void register_subscription_factory(
+    TypeId register_subscription_factory(
             const std::string& topic_type,
             RegisterSubscriptionToFactory register_sub_func);
 
@@ -145,6 +182,9 @@ public:
      *
      * @param[in] transport_hints Provides the subscriber with specific transport information.
      *
+     * @param[in] options The bridge-side options of the topic, already parsed and validated
+     *            from its user-provided *YAML* configuration.
+     *
      * @returns An opaque pointer to the created *Integration Service* subscription entity.
      */
     std::shared_ptr<void> create_subscription(
@@ -153,7 +193,8 @@ public:
             const std::string& topic_name,
             TopicSubscriberSystem::SubscriptionCallback* callback,
             uint32_t queue_size,
-            const ros::TransportHints& transport_hints);
+            const ros::TransportHints& transport_hints,
+            const TopicOptions& options);
 
     /**
      * @brief Signature for the method that will be used to create a ROS 1 publisher
@@ -175,7 +216,8 @@ public:
                         ros::NodeHandle& node,
                         const std::string& topic_name,
                         uint32_t queue_size,
-                        bool latch)>;
+                        bool latch,
+                        const TopicOptions& options)>;
 
     /**
      * @brief Register a ROS 1 publisher builder within the Factory.
@@ -183,8 +225,10 @@ public:
      * @param[in] topic_type The name of the topic type, used to index the publisher factory map.
      *
      * @param[in] register_pub_func The function used to create the publisher.
+     *
+     * @returns The interned handle of the type name.
      */
-    void register_publisher_factory(
+    TypeId register_publisher_factory(
             const std::string& topic_type,
             RegisterPublisherToFactory register_pub_func);
 
@@ -203,6 +247,9 @@ public:
      * @param[in] latch Enable/disable latching. When a connection is latched,
      *            the last message published is saved and sent to any future subscribers that connect.
      *
+     * @param[in] options The bridge-side options of the topic, already parsed and validated
+     *            from its user-provided *YAML* configuration.
+     *
      * @returns A pointer to the created *Integration Service* TopicPublisher entity.
      */
     std::shared_ptr<TopicPublisher> create_publisher(
@@ -210,15 +257,48 @@ public:
             ros::NodeHandle& node,
             const std::string& topic_name,
             uint32_t queue_size,
-            bool latch);
+            bool latch,
+            const TopicOptions& options);
+
+    /**
+     * @brief Create a ROS 1 publisher handler for the *Integration Service*, looking up
+     *        the publisher registered previously in the Factory by its interned handle.
+     *
+     * @details Meant for the publishers created while bridging messages, such as the ones
+     *          whose topic name is computed from each message.
+     *
+     * @param[in] topic_type_id The interned handle of the topic type, as returned by type_id().
+     *
+     * @param[in] node The ROS 1 node that will hold this publisher.
+     *
+     * @param[in] topic_name The topic name to publish to.
+     *
+     * @param[in] queue_size The maximum message queue size for the ROS 1 publisher.
+     *
+     * @param[in] latch Enable/disable latching. When a connection is latched,
+     *            the last message published is saved and sent to any future subscribers that connect.
+     *
+     * @param[in] options The bridge-side options of the topic, already parsed and validated
+     *            from its user-provided *YAML* configuration.
+     *
+     * @returns A pointer to the created *Integration Service* TopicPublisher entity.
+     */
+    std::shared_ptr<TopicPublisher> create_publisher(
+            TypeId topic_type_id,
+            ros::NodeHandle& node,
+            const std::string& topic_name,
+            uint32_t queue_size,
+            bool latch,
+            const TopicOptions& options);
 
     /**
      * @brief Signature for the method that will be used to create a ROS 1 service client
      *        to a certain service, within the service clients factory.
      *
      * @details It allows to specify the associated ROS 1 node, the service name,
-     *          as well as the callback function called every time a new request data
-     *          arrives to this service client.
+     *          the callback function called every time a new request data
+     *          arrives to this service client, as well as the service specific
+     *          configuration, such as the time to wait for the reply.
      *
      *          This Factory method returns a pointer containing the *Integration Service*
      *          ServiceClient object created by the *Integration Service* to manage a service client.
@@ -231,7 +311,8 @@ public:
             std::function<std::shared_ptr<ServiceClient>(
                         ros::NodeHandle& node,
                         const std::string& service_name,
-                        ServiceClientSystem::RequestCallback* callback)>;
+                        ServiceClientSystem::RequestCallback* callback,
+                        const YAML::Node& configuration)>;
 
     /**
      * @brief Register a ROS 1 service client builder within the Factory.
@@ -240,8 +321,10 @@ public:
      *            used as index in the service client factory map.
      *
      * @param[in] register_service_client_func The function used to create the service client.
+     *
+     * @returns The interned handle of the type name.
      */
-    void register_client_proxy_factory(
+    TypeId register_client_proxy_factory(
             const std::string& service_response_type,
             RegisterServiceClientToFactory register_service_client_func);
 
@@ -259,20 +342,26 @@ public:
      * @param[in] callback The callback function called every time the ROS 1 service client
      *            receives a new request.
      *
+     * @param[in] configuration The service specific configuration,
+     *            as described in the user-provided *YAML* input file.
+     *
      * @returns A pointer to the created *Integration Service* ServiceClient entity.
      */
     std::shared_ptr<ServiceClient> create_client_proxy(
             const std::string& service_response_type,
             ros::NodeHandle& node,
             const std::string& service_name,
-            ServiceClientSystem::RequestCallback* callback);
+            ServiceClientSystem::RequestCallback* callback,
+            const YAML::Node& configuration);
 
     /**
      * @brief Signature for the method that will be used to create a ROS 1 service server
      *        to a certain service, within the service servers factory.
      *
      * @details
-     *          It allows to specify the associated ROS 1 node and the service name.
+     *          It allows to specify the associated ROS 1 node, the service name and
+     *          the service specific configuration, such as the size of the worker pool
+     *          that forwards the requests to the ROS 1 service server.
      *
      *          This Factory method returns a pointer containing the *Integration Service*
      *          ServiceProvider object created by the *Integration Service* to manage a service server.
@@ -284,7 +373,8 @@ public:
     using RegisterServiceProviderToFactory =
             std::function<std::shared_ptr<ServiceProvider>(
                         ros::NodeHandle& node,
-                        const std::string& service_name)>;
+                        const std::string& service_name,
+                        const YAML::Node& configuration)>;
 
     /**
      * @brief Register a ROS 1 service server builder within the Factory.
@@ -292,8 +382,10 @@ public:
      * @param[in] service_request_type The name of the service server type to be registered.
      *
      * @param[in] register_service_server_func The function used to create the service server.
+     *
+     * @returns The interned handle of the type name.
      */
-    void register_server_proxy_factory(
+    TypeId register_server_proxy_factory(
             const std::string& service_request_type,
             RegisterServiceProviderToFactory register_service_server_func);
 
@@ -308,12 +400,16 @@ public:
      *
      * @param[in] service_name The name of the service.
      *
+     * @param[in] configuration The service specific configuration,
+     *            as described in the user-provided *YAML* input file.
+     *
      * @returns A pointer to the created *Integration Service* ServiceProvider entity.
      */
     std::shared_ptr<ServiceProvider> create_server_proxy(
             const std::string& service_request_type,
             ros::NodeHandle& node,
-            const std::string& service_name);
+            const std::string& service_name,
+            const YAML::Node& configuration);
 
 private:
 
@@ -351,10 +447,10 @@ private:
  *
  * @tparam FactoryType The type of Factory to register a Factory method to.
  *
- * @tparam void(Factory::* register_func)(const std::string&, FactoryType) A pointer to the
+ * @tparam Factory::TypeId(Factory::* register_func)(const std::string&, FactoryType) A pointer to the
  *         register method.
  */
-template<typename FactoryType, void(Factory::* register_func)(const std::string&, FactoryType)>
+template<typename FactoryType, Factory::TypeId(Factory::* register_func)(const std::string&, FactoryType)>
 struct FactoryRegistrar
 {
     /**
@@ -368,10 +464,15 @@ struct FactoryRegistrar
     FactoryRegistrar(
             const std::string& type,
             FactoryType factory)
+        : id((Factory::instance().*register_func)(type, factory))
     {
-        (Factory::instance().*register_func)(type, factory);
     }
 
+    /**
+     * @brief The interned handle of the registered type name.
+     */
+    const Factory::TypeId id;
+
 };
 
 //==============================================================================
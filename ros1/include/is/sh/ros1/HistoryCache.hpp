@@ -0,0 +1,250 @@
+/*
+ * Copyright (C) 2020 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _IS_SH_ROS1__INCLUDE__HISTORYCACHE_HPP_
+#define _IS_SH_ROS1__INCLUDE__HISTORYCACHE_HPP_
+
+#include <is/sh/ros1/Metrics.hpp>
+
+#include <ros/message_traits.h>
+#include <ros/serialization.h>
+#include <ros/single_subscriber_publisher.h>
+
+#include <boost/shared_array.hpp>
+
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace ros1 {
+
+/**
+ * @struct SerializedMessageCopy
+ * @brief A ROS 1 message of type `Msg`, already serialized.
+ *
+ * @details It can be published by any ros::Publisher advertised for `Msg`, and by the
+ *          ros::SingleSubscriberPublisher of its connection callbacks, which then just
+ *          copy the bytes out instead of serializing the message again.
+ *          The bytes are shared among the copies of this object.
+ *
+ * @tparam Msg The ROS 1 message type.
+ */
+template<typename Msg>
+struct SerializedMessageCopy
+{
+    /**
+     * @brief Serialize a message.
+     *
+     * @param[in] msg The message.
+     */
+    explicit SerializedMessageCopy(
+            const Msg& msg)
+        : size(ros::serialization::serializationLength(msg))
+        , data(new uint8_t[size])
+    {
+        ros::serialization::OStream stream(data.get(), size);
+        ros::serialization::serialize(stream, msg);
+    }
+
+    uint32_t size;
+    boost::shared_array<uint8_t> data;
+};
+
+/**
+ * @class HistoryCache
+ * @brief Keeps the last messages published on a topic, in their serialized form,
+ *        and replays them to the subscribers that connect later on.
+ *
+ * @details The serialized size of the kept messages is accounted in the `memory` metric of the entity.
+ *
+ * @tparam Msg The ROS 1 message type.
+ */
+template<typename Msg>
+class HistoryCache
+{
+public:
+
+    using Entry = SerializedMessageCopy<Msg>;
+
+    HistoryCache(
+            std::size_t depth,
+            std::shared_ptr<EntityMetrics> metrics)
+        : _depth(depth)
+        , _metrics(std::move(metrics))
+    {
+    }
+
+    ~HistoryCache()
+    {
+        for (const Entry& entry : _history)
+        {
+            _metrics->memory.fetch_sub(entry.size, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Serialize a message into the history, and publish it.
+     *
+     * @details The history lock is held while publishing, so that a subscriber
+     *          being replayed the history meanwhile gets the messages in order.
+     *
+     * @param[in] publisher The publisher of the topic.
+     *
+     * @param[in] msg The message.
+     */
+    void publish(
+            const ros::Publisher& publisher,
+            const Msg& msg)
+    {
+        publish(publisher, Entry(msg));
+    }
+
+    /**
+     * @brief Keep an already serialized message in the history, and publish it.
+     *
+     * @param[in] publisher The publisher of the topic.
+     *
+     * @param[in] entry The serialized message, whose bytes are shared with the history.
+     */
+    void publish(
+            const ros::Publisher& publisher,
+            const Entry& entry)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_history.size() >= _depth)
+        {
+            _metrics->memory.fetch_sub(_history.front().size, std::memory_order_relaxed);
+            _history.pop_front();
+        }
+        _history.push_back(entry);
+        _metrics->memory.fetch_add(entry.size, std::memory_order_relaxed);
+
+        publisher.publish(entry);
+    }
+
+    /**
+     * @brief Replay the history to a subscriber that just connected.
+     *
+     * @param[in] subscriber The publisher for that very subscriber.
+     */
+    void replay(
+            const ros::SingleSubscriberPublisher& subscriber)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (const Entry& entry : _history)
+        {
+            subscriber.publish(entry);
+        }
+    }
+
+private:
+
+    const std::size_t _depth;
+
+    const std::shared_ptr<EntityMetrics> _metrics;
+
+    std::mutex _mutex;
+    std::deque<Entry> _history;
+};
+
+} //  namespace ros1
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
+
+namespace ros {
+namespace message_traits {
+
+template<typename Msg>
+struct MD5Sum<eprosima::is::sh::ros1::SerializedMessageCopy<Msg> >
+{
+    static const char* value()
+    {
+        return MD5Sum<Msg>::value();
+    }
+
+    static const char* value(
+            const eprosima::is::sh::ros1::SerializedMessageCopy<Msg>&)
+    {
+        return value();
+    }
+
+};
+
+template<typename Msg>
+struct DataType<eprosima::is::sh::ros1::SerializedMessageCopy<Msg> >
+{
+    static const char* value()
+    {
+        return DataType<Msg>::value();
+    }
+
+    static const char* value(
+            const eprosima::is::sh::ros1::SerializedMessageCopy<Msg>&)
+    {
+        return value();
+    }
+
+};
+
+template<typename Msg>
+struct Definition<eprosima::is::sh::ros1::SerializedMessageCopy<Msg> >
+{
+    static const char* value()
+    {
+        return Definition<Msg>::value();
+    }
+
+    static const char* value(
+            const eprosima::is::sh::ros1::SerializedMessageCopy<Msg>&)
+    {
+        return value();
+    }
+
+};
+
+} //  namespace message_traits
+
+namespace serialization {
+
+template<typename Msg>
+struct Serializer<eprosima::is::sh::ros1::SerializedMessageCopy<Msg> >
+{
+    template<typename Stream>
+    inline static void write(
+            Stream& stream,
+            const eprosima::is::sh::ros1::SerializedMessageCopy<Msg>& m)
+    {
+        std::memcpy(stream.advance(m.size), m.data.get(), m.size);
+    }
+
+    inline static uint32_t serializedLength(
+            const eprosima::is::sh::ros1::SerializedMessageCopy<Msg>& m)
+    {
+        return m.size;
+    }
+
+};
+
+} //  namespace serialization
+} //  namespace ros
+
+#endif //  _IS_SH_ROS1__INCLUDE__HISTORYCACHE_HPP_
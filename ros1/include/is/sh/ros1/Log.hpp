@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2020 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _IS_SH_ROS1__INCLUDE__LOG_HPP_
+#define _IS_SH_ROS1__INCLUDE__LOG_HPP_
+
+#include <is/utils/Log.hpp>
+
+#include <atomic>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace ros1 {
+
+/**
+ * @brief Get the minimum level that the per-message traces of the generated
+ *        converters must have in order to be formatted and logged.
+ *
+ * @details It is shared by the ROS 1 SystemHandle and every *mix* library,
+ *          and configured through the `message_log_level` system option.
+ *
+ *          The level utils::Logger filters at cannot be queried from here, so this gate cannot
+ *          follow it. It defaults to `WARN` instead: the `INFO` traces, which stringify every
+ *          bridged message, are only formatted once `message_log_level` explicitly asks for them.
+ *
+ * @returns A mutable reference to the process-wide hot path log level.
+ */
+inline std::atomic<utils::Logger::Level>& hot_path_log_level()
+{
+    static std::atomic<utils::Logger::Level> level(utils::Logger::Level::WARN);
+    return level;
+}
+
+/**
+ * @brief Check whether a per-message trace of the given level must be logged.
+ *
+ * @param[in] level The level of the trace.
+ *
+ * @returns `true` if the trace must be formatted and logged, `false` otherwise.
+ */
+inline bool hot_path_log_enabled(
+        utils::Logger::Level level)
+{
+    return static_cast<int>(level) >=
+           static_cast<int>(hot_path_log_level().load(std::memory_order_relaxed));
+}
+
+} //  namespace ros1
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
+
+/**
+ * @brief Log a per-message trace, formatting the message only if its level is enabled.
+ *
+ * @details If `IS_ROS1_STRIP_HOT_PATH_LOGS` is defined, the trace is removed at compile time.
+ *
+ * @param[in] logger The utils::Logger instance to use.
+ *
+ * @param[in] level The utils::Logger::Level of the trace.
+ *
+ * @param[in] message The chain of streamable elements forming the trace,
+ *            for example `"Received message: " << data`.
+ */
+#ifdef IS_ROS1_STRIP_HOT_PATH_LOGS
+#  define IS_ROS1_HOT_PATH_LOG(logger, level, message) \
+    do {} while (0)
+#else
+#  define IS_ROS1_HOT_PATH_LOG(logger, level, message) \
+    do \
+    { \
+        if (::eprosima::is::sh::ros1::hot_path_log_enabled(level)) \
+        { \
+            logger << level << message << std::endl; \
+        } \
+    } while (0)
+#endif //  IS_ROS1_STRIP_HOT_PATH_LOGS
+
+#endif //  _IS_SH_ROS1__INCLUDE__LOG_HPP_
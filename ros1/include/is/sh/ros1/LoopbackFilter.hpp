@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2020 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _IS_SH_ROS1__INCLUDE__LOOPBACKFILTER_HPP_
+#define _IS_SH_ROS1__INCLUDE__LOOPBACKFILTER_HPP_
+
+#include <ros/node_handle.h>
+#include <ros/subscription_callback_helper.h>
+#include <ros/this_node.h>
+
+#include <boost/make_shared.hpp>
+
+#include <array>
+#include <memory>
+#include <mutex>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace ros1 {
+
+/**
+ * @class LoopbackFilter
+ * @brief Tells apart the messages published by the *Integration Service* node itself,
+ *        so that a subscription does not bridge back its own publications.
+ *
+ * @details Every ROS 1 connection owns a single connection header, which is shared by
+ *          all the messages received through it. The result of comparing its `callerid`
+ *          with the node name is therefore cached, keyed on the connection header, and
+ *          each connection pays for the string comparison only once.
+ *
+ *          It is thread safe. roscpp deserializes the messages of a connection with the helper
+ *          of the first subscription of their type, so a filter also runs for the messages of
+ *          other subscriptions of the topic, from their callback threads, while the callback of
+ *          its own subscription checks the intraprocess messages, which skip deserialization.
+ *          For the same reason, it is shared with the helpers, which may outlive the subscription.
+ */
+class LoopbackFilter
+{
+public:
+
+    /**
+     * @brief Check whether a message comes from a publisher of this very node.
+     *
+     * @param[in] connection_header The header of the connection the message was received from.
+     *
+     * @returns `true` if the message was published by this node, `false` otherwise.
+     */
+    bool is_local(
+            const boost::shared_ptr<ros::M_string>& connection_header)
+    {
+        if (!connection_header)
+        {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        for (const Entry& entry : _entries)
+        {
+            if (entry.connection_header == connection_header)
+            {
+                return entry.local;
+            }
+        }
+
+        const ros::M_string::const_iterator callerid = connection_header->find("callerid");
+        const bool local = callerid != connection_header->end()
+                && callerid->second == ros::this_node::getName();
+
+        // Keeping the connection header alive prevents its address from being
+        // reused by a later connection while it is cached here.
+        Entry& entry = _entries[_next_entry];
+        entry.connection_header = connection_header;
+        entry.local = local;
+        _next_entry = (_next_entry + 1) % _entries.size();
+
+        return local;
+    }
+
+private:
+
+    struct Entry
+    {
+        boost::shared_ptr<ros::M_string> connection_header;
+        bool local = false;
+    };
+
+    std::mutex _mutex;
+    std::array<Entry, 4> _entries;
+    std::size_t _next_entry = 0;
+};
+
+/**
+ * @class LoopbackFilteringCallbackHelper
+ * @brief Subscription callback helper that discards the local publications
+ *        before deserializing them.
+ *
+ * @tparam M The ROS 1 message type of the subscription.
+ */
+template<typename M>
+class LoopbackFilteringCallbackHelper
+    : public ros::SubscriptionCallbackHelperT<const ros::MessageEvent<M const>&>
+{
+public:
+
+    using Base = ros::SubscriptionCallbackHelperT<const ros::MessageEvent<M const>&>;
+
+    /**
+     * @brief Construct a new LoopbackFilteringCallbackHelper object.
+     *
+     * @param[in] callback The subscription callback.
+     *
+     * @param[in] filter The loopback filter of the subscription.
+     */
+    LoopbackFilteringCallbackHelper(
+            const typename Base::Callback& callback,
+            std::shared_ptr<LoopbackFilter> filter)
+        : Base(callback)
+        , _filter(std::move(filter))
+    {
+    }
+
+    /**
+     * @brief Inherited from ros::SubscriptionCallbackHelperT.
+     *
+     * @details Returning a null message makes roscpp skip the callback.
+     */
+    ros::VoidConstPtr deserialize(
+            const ros::SubscriptionCallbackHelperDeserializeParams& params) override
+    {
+        if (_filter->is_local(params.connection_header))
+        {
+            return ros::VoidConstPtr();
+        }
+
+        return Base::deserialize(params);
+    }
+
+private:
+
+    const std::shared_ptr<LoopbackFilter> _filter;
+};
+
+/**
+ * @brief Build the options for a ROS 1 subscription whose local publications
+ *        are discarded before deserialization.
+ *
+ * @tparam M The ROS 1 message type of the subscription.
+ *
+ * @param[in] topic_name The topic name to be subscribed to.
+ *
+ * @param[in] queue_size The maximum message queue size for the ROS 1 subscription.
+ *
+ * @param[in] callback The subscription callback.
+ *
+ * @param[in] filter The loopback filter of the subscription.
+ *
+ * @param[in] transport_hints Provides the subscriber with specific transport information.
+ *
+ * @returns The subscription options, to be passed to ros::NodeHandle::subscribe.
+ */
+template<typename M>
+ros::SubscribeOptions make_loopback_filtering_options(
+        const std::string& topic_name,
+        uint32_t queue_size,
+        const boost::function<void(const ros::MessageEvent<M const>&)>& callback,
+        const std::shared_ptr<LoopbackFilter>& filter,
+        const ros::TransportHints& transport_hints)
+{
+    ros::SubscribeOptions options;
+    options.topic = topic_name;
+    options.queue_size = queue_size;
+    options.md5sum = ros::message_traits::md5sum<M>();
+    options.datatype = ros::message_traits::datatype<M>();
+    options.helper = boost::make_shared<LoopbackFilteringCallbackHelper<M> >(callback, filter);
+    options.transport_hints = transport_hints;
+    return options;
+}
+
+} //  namespace ros1
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
+
+#endif //  _IS_SH_ROS1__INCLUDE__LOOPBACKFILTER_HPP_
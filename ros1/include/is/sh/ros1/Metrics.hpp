@@ -0,0 +1,316 @@
+/*
+ * Copyright (C) 2020 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _IS_SH_ROS1__INCLUDE__METRICS_HPP_
+#define _IS_SH_ROS1__INCLUDE__METRICS_HPP_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace ros1 {
+
+/**
+ * @brief Check whether the runtime metrics are being recorded.
+ *
+ * @details It is shared by the ROS 1 SystemHandle and every *mix* library,
+ *          and enabled through the `metrics` system option.
+ *
+ * @returns A mutable reference to the process-wide metrics switch.
+ */
+inline std::atomic<bool>& metrics_enabled()
+{
+    static std::atomic<bool> enabled(false);
+    return enabled;
+}
+
+/**
+ * @class Histogram
+ * @brief Lock-free histogram of durations, in nanoseconds, with power of two buckets.
+ */
+class Histogram
+{
+public:
+
+    /**
+     * Bucket `i` holds the durations in `[2^(i-1), 2^i)` nanoseconds,
+     * and the last one everything from about 2 seconds on.
+     */
+    static constexpr std::size_t bucket_count = 32;
+
+    using Buckets = std::array<uint64_t, bucket_count>;
+
+    void record(
+            uint64_t nanoseconds)
+    {
+        std::size_t bucket = 0;
+        while (nanoseconds && bucket < bucket_count - 1)
+        {
+            nanoseconds >>= 1;
+            ++bucket;
+        }
+
+        _buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Buckets load() const
+    {
+        Buckets buckets;
+        for (std::size_t i = 0; i < bucket_count; ++i)
+        {
+            buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+        }
+        return buckets;
+    }
+
+    /**
+     * @brief Estimate a percentile from a set of buckets.
+     *
+     * @param[in] buckets The bucket counts, as returned by load().
+     *
+     * @param[in] ratio The percentile, from 0 to 1.
+     *
+     * @returns The upper bound, in nanoseconds, of the bucket holding the percentile,
+     *          or 0 if the histogram is empty.
+     */
+    static uint64_t percentile(
+            const Buckets& buckets,
+            double ratio)
+    {
+        uint64_t total = 0;
+        for (const uint64_t count : buckets)
+        {
+            total += count;
+        }
+
+        if (0 == total)
+        {
+            return 0;
+        }
+
+        const uint64_t target = static_cast<uint64_t>(ratio * (total - 1));
+        uint64_t accumulated = 0;
+        for (std::size_t i = 0; i < bucket_count; ++i)
+        {
+            accumulated += buckets[i];
+            if (accumulated > target)
+            {
+                return uint64_t(1) << i;
+            }
+        }
+
+        return uint64_t(1) << (bucket_count - 1);
+    }
+
+private:
+
+    std::array<std::atomic<uint64_t>, bucket_count> _buckets{};
+};
+
+/**
+ * @struct EntityMetrics
+ * @brief The metrics recorded by a bridged publisher, subscription or service proxy.
+ *
+ * @details Every member is updated with relaxed atomic operations by the entity itself,
+ *          so recording never takes a lock, and snapshots can be taken at any time.
+ */
+struct EntityMetrics
+{
+    EntityMetrics(
+            const std::string& kind_,
+            const std::string& name_)
+        : kind(kind_)
+        , name(name_)
+    {
+    }
+
+    /**
+     * @brief Record a bridged message or service call.
+     *
+     * @param[in] bytes_ The serialized size of the ROS 1 message.
+     *
+     * @param[in] nanoseconds The time spent converting the message, or serving the call.
+     */
+    void record(
+            uint64_t bytes_,
+            uint64_t nanoseconds)
+    {
+        messages.fetch_add(1, std::memory_order_relaxed);
+        bytes.fetch_add(bytes_, std::memory_order_relaxed);
+        duration.record(nanoseconds);
+    }
+
+    /**
+     * Either `subscription`, `publisher`, `service_client`, `service_server` or `spin`.
+     */
+    const std::string kind;
+
+    /**
+     * The topic or service name.
+     */
+    const std::string name;
+
+    std::atomic<uint64_t> messages{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> errors{0};
+    std::atomic<int64_t> in_flight{0};
+
+    /**
+     * Approximate number of bytes held by the entity on its own, besides roscpp and the shared types:
+     * its message buffers, bridge-side queues, histories and service workers. Unlike the rest of the
+     * metrics, it is kept up to date regardless of whether the metrics are enabled.
+     */
+    std::atomic<int64_t> memory{0};
+
+    /**
+     * For topics, the conversion time of each message; for services, the latency of each call;
+     * and for the `spin` entity, the duration of each spin, waiting for callbacks included.
+     */
+    Histogram duration;
+};
+
+/**
+ * @struct MetricsSnapshot
+ * @brief A copy of the metrics of an entity at a given time.
+ */
+struct MetricsSnapshot
+{
+    std::string kind;
+    std::string name;
+    uint64_t messages;
+    uint64_t bytes;
+    uint64_t dropped;
+    uint64_t errors;
+    int64_t in_flight;
+    int64_t memory;
+    Histogram::Buckets duration;
+    std::chrono::steady_clock::time_point time;
+};
+
+/**
+ * @class Metrics
+ * @brief Process-wide registry of the metrics of every bridged entity.
+ */
+class Metrics
+{
+public:
+
+    /**
+     * @brief Get a reference to the singleton instance of the registry.
+     */
+    static Metrics& instance();
+
+    /**
+     * @brief Create the metrics of an entity.
+     *
+     * @details The registry only keeps track of the metrics while the returned pointer,
+     *          held by the entity, is alive. The metrics are freed as soon as the entity
+     *          releases them, and the registry forgets them on the next snapshot, or once
+     *          enough entities have been created in the meantime. Unless the metrics
+     *          are enabled, they are not registered at all, and only keep the counters
+     *          the entity relies on.
+     *
+     * @param[in] kind The kind of entity, as described in EntityMetrics::kind.
+     *
+     * @param[in] name The topic or service name.
+     *
+     * @returns The metrics to be recorded by the entity.
+     */
+    std::shared_ptr<EntityMetrics> create(
+            const std::string& kind,
+            const std::string& name);
+
+    /**
+     * @brief Take a snapshot of the metrics of every live entity.
+     *
+     * @details The entities keep recording while the snapshot is taken,
+     *          so the values of different counters may be a few messages apart.
+     */
+    std::vector<MetricsSnapshot> snapshot();
+
+    /**
+     * @brief Get the resident set size of the process.
+     *
+     * @returns The resident memory, in bytes, or 0 if it cannot be read on this platform.
+     */
+    static uint64_t resident_memory();
+
+private:
+
+    Metrics() = default;
+
+    /**
+     * Must be called with the mutex held.
+     */
+    void prune();
+
+    std::mutex _mutex;
+    std::vector<std::weak_ptr<EntityMetrics> > _entities;
+
+    /**
+     * Size of the registry that triggers a prune from create(), so that the entities
+     * created and destroyed without any snapshot being taken do not pile up.
+     */
+    std::size_t _prune_threshold = 64;
+};
+
+/**
+ * @class MetricsStopwatch
+ * @brief Measures the duration of a bridging step, only if the metrics are enabled.
+ */
+class MetricsStopwatch
+{
+public:
+
+    MetricsStopwatch()
+        : _running(metrics_enabled().load(std::memory_order_relaxed))
+        , _start(_running ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point())
+    {
+    }
+
+    bool running() const
+    {
+        return _running;
+    }
+
+    uint64_t elapsed_ns() const
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now() - _start).count());
+    }
+
+private:
+
+    const bool _running;
+    const std::chrono::steady_clock::time_point _start;
+};
+
+} //  namespace ros1
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
+
+#endif //  _IS_SH_ROS1__INCLUDE__METRICS_HPP_
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2020 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _IS_SH_ROS1__INCLUDE__OVERFLOWQUEUE_HPP_
+#define _IS_SH_ROS1__INCLUDE__OVERFLOWQUEUE_HPP_
+
+#include <is/sh/ros1/TopicOptions.hpp>
+
+#include <boost/shared_ptr.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace ros1 {
+
+struct EntityMetrics;
+
+/**
+ * @class OverflowQueue
+ * @brief Bounded queue of messages, drained by its own thread, which applies
+ *        the overflow policy of a topic whenever the handler falls behind.
+ *
+ * @details The dropped messages are counted in the `dropped` metric of the entity,
+ *          and the current depth of the queue is reported as its `in_flight` metric,
+ *          both regardless of whether the metrics are enabled.
+ *
+ *          The messages are type erased, so that a single implementation serves every
+ *          message type, and the handler casts them back to the type it pushed.
+ */
+class OverflowQueue
+{
+public:
+
+    using MsgConstPtr = boost::shared_ptr<const void>;
+
+    using Handler = std::function<void (const MsgConstPtr&)>;
+
+    OverflowQueue(
+            const OverflowOptions& options,
+            Handler handler,
+            std::shared_ptr<EntityMetrics> metrics);
+
+    ~OverflowQueue();
+
+    /**
+     * @brief Queue a message for the handler.
+     *
+     * @param[in] msg The message.
+     *
+     * @returns `false` if the message was dropped.
+     */
+    bool push(
+            const MsgConstPtr& msg);
+
+private:
+
+    void drain();
+
+    const OverflowOptions _options;
+
+    const Handler _handler;
+
+    const std::shared_ptr<EntityMetrics> _metrics;
+
+    std::mutex _mutex;
+    std::condition_variable _not_empty;
+    std::condition_variable _not_full;
+    std::deque<MsgConstPtr> _queue;
+    bool _stop = false;
+
+    std::thread _thread;
+};
+
+} //  namespace ros1
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
+
+#endif //  _IS_SH_ROS1__INCLUDE__OVERFLOWQUEUE_HPP_
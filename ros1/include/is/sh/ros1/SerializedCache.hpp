@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2020 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _IS_SH_ROS1__INCLUDE__SERIALIZEDCACHE_HPP_
+#define _IS_SH_ROS1__INCLUDE__SERIALIZEDCACHE_HPP_
+
+#include <is/sh/ros1/DirectRoute.hpp>
+#include <is/sh/ros1/HistoryCache.hpp>
+
+#include <xtypes/xtypes.hpp>
+
+#include <memory>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace ros1 {
+
+/**
+ * @struct SerializedCache
+ * @brief The last DynamicData instance converted and serialized as a ROS 1 message
+ *        of type `Msg` by the calling thread, along with the result.
+ *
+ * @details *Integration Service* hands the very same DynamicData instance over to every
+ *          publisher of a topic, one after the other, from the same thread. So the ROS 1
+ *          publishers of a same type that receive it, whether they belong to several routes
+ *          or to several topic templates, can share one conversion and serialization.
+ *
+ *          A DynamicData instance is usually reused for the successive messages of its source,
+ *          so a cached result only stands for as long as the instance holds the same message:
+ *          - For the messages coming from a ROS 1 subscription, while their DirectSourceScope lasts.
+ *          - Otherwise, while the instance compares equal to the snapshot taken along with the result.
+ *
+ * @tparam Msg The ROS 1 message type.
+ */
+template<typename Msg>
+struct SerializedCache
+{
+    const xtypes::DynamicData* data = nullptr;
+
+    /// The DirectSource sequence of the message, or zero if it did not come from ROS 1.
+    uint64_t sequence = 0;
+
+    std::unique_ptr<xtypes::DynamicData> snapshot;
+
+    std::unique_ptr<SerializedMessageCopy<Msg> > message;
+
+    /**
+     * @brief Get the cache of the calling thread.
+     */
+    static SerializedCache& instance()
+    {
+        static thread_local SerializedCache cache;
+        return cache;
+    }
+
+    /**
+     * @brief Get the serialized form of a DynamicData instance, if it is in the cache.
+     *
+     * @param[in] message The DynamicData instance received by a publisher.
+     *
+     * @returns The serialized message, or `nullptr` if it has to be converted.
+     */
+    static const SerializedMessageCopy<Msg>* find(
+            const xtypes::DynamicData& message)
+    {
+        const SerializedCache& cache = instance();
+        if (cache.data != &message || !cache.message)
+        {
+            return nullptr;
+        }
+
+        if (0 != cache.sequence)
+        {
+            const DirectSource& source = current_direct_source();
+            return source.data == &message && source.sequence == cache.sequence
+                   ? cache.message.get() : nullptr;
+        }
+
+        return cache.snapshot && *cache.snapshot == message ? cache.message.get() : nullptr;
+    }
+
+    /**
+     * @brief Tell whether a message coming from a ROS 1 subscription was already published
+     *        by another ROS 1 publisher of the same type, and remember it for the next ones.
+     *
+     * @details It lets the first publisher of a message publish it as it is, which spares
+     *          the serialized copy to the topics that do not fan out at all.
+     *
+     * @param[in] message The DynamicData instance received by a publisher,
+     *            which must be the current direct source.
+     *
+     * @returns `true` if a previous publisher already got the same message.
+     */
+    static bool repeated(
+            const xtypes::DynamicData& message)
+    {
+        SerializedCache& cache = instance();
+        const DirectSource& source = current_direct_source();
+        if (cache.data == &message && 0 != cache.sequence && cache.sequence == source.sequence)
+        {
+            return true;
+        }
+
+        cache.data = &message;
+        cache.sequence = source.sequence;
+        cache.snapshot.reset();
+        cache.message.reset();
+        return false;
+    }
+
+    /**
+     * @brief Serialize the ROS 1 message that a DynamicData instance was converted into,
+     *        and keep it in the cache for the rest of the publishers of the instance.
+     *
+     * @param[in] message The DynamicData instance.
+     *
+     * @param[in] msg The ROS 1 message.
+     *
+     * @param[in] snapshot Whether to take a snapshot of the instance, to tell whether it still
+     *            holds the same message later on. Otherwise, only the messages coming from a
+     *            ROS 1 subscription are found again.
+     *
+     * @returns The serialized message, valid until the next call from the same thread.
+     */
+    static const SerializedMessageCopy<Msg>& store(
+            const xtypes::DynamicData& message,
+            const Msg& msg,
+            bool snapshot)
+    {
+        SerializedCache& cache = instance();
+        cache.message.reset(new SerializedMessageCopy<Msg>(msg));
+
+        const DirectSource& source = current_direct_source();
+        cache.data = &message;
+        cache.sequence = source.data == &message ? source.sequence : 0;
+        cache.snapshot.reset();
+
+        if (0 == cache.sequence)
+        {
+            if (snapshot)
+            {
+                cache.snapshot.reset(new xtypes::DynamicData(message));
+            }
+            else
+            {
+                cache.data = nullptr;
+            }
+        }
+
+        return *cache.message;
+    }
+};
+
+} //  namespace ros1
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
+
+#endif //  _IS_SH_ROS1__INCLUDE__SERIALIZEDCACHE_HPP_
@@ -0,0 +1,276 @@
+/*
+ * Copyright (C) 2020 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _IS_SH_ROS1__INCLUDE__SHAREDMEMORY_HPP_
+#define _IS_SH_ROS1__INCLUDE__SHAREDMEMORY_HPP_
+
+#include <is/sh/ros1/TopicOptions.hpp>
+
+#include <ros/serialization.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace ros1 {
+
+/**
+ * @class SharedMemoryRing
+ * @brief Ring of fixed-size slots in a shared memory segment, holding serialized ROS 1 messages.
+ *
+ * @details A writer serializes each message straight into the next slot, and then tells the readers
+ *          which slot to look at by publishing the returned handle over a regular ROS 1 topic,
+ *          of type `std_msgs/UInt64`. So only those 8 bytes go through the sockets,
+ *          whatever the size of the message.
+ *
+ *          Every slot carries a sequence number, which is odd while the slot is being written.
+ *          A reader checks it before and after copying the slot out, so that it never hands over
+ *          a message the writer overwrote meanwhile, which happens if the reader falls behind by
+ *          more than the number of slots. Such messages are reported as `OVERWRITTEN` and dropped.
+ *
+ *          Several writers may share a segment, which is removed once the last of them goes away.
+ *          Each writer holds a shared `flock` on the segment while it lives, so a segment that
+ *          nobody holds locked was left behind by writers that crashed, and the next writer
+ *          replaces it with a new one. The readers open the new segment as soon as they get
+ *          one of its handles.
+ *          ROS 1 nodes running in the same host can link against this library and use this class
+ *          to exchange messages with the *Integration Service* through shared memory.
+ */
+class SharedMemoryRing
+{
+public:
+
+    enum class ReadResult
+    {
+        OK,
+
+        /// The writer reused the slot before the message could be read.
+        OVERWRITTEN,
+
+        /// The handle or the slot contents are not valid.
+        INVALID
+    };
+
+    /**
+     * @brief Create a shared memory segment, or attach to an existing one, to write to it.
+     *
+     * @param[in] options The segment name and layout. The name must be set,
+     *            as SharedMemoryOptions::for_topic() does.
+     *
+     * @param[in] datatype The ROS 1 type of the messages, such as `sensor_msgs/Image`.
+     *
+     * @param[in] md5sum The MD5 sum of the ROS 1 type.
+     *
+     * @param[out] error The reason of the failure, if any.
+     *
+     * @returns The ring, or `nullptr` if the segment could not be created, or the existing
+     *          one, still in use by other writers, has a different type or layout.
+     */
+    static std::unique_ptr<SharedMemoryRing> create(
+            const SharedMemoryOptions& options,
+            const std::string& datatype,
+            const std::string& md5sum,
+            std::string& error);
+
+    /**
+     * @brief Attach to an existing shared memory segment, to read from it.
+     *
+     * @param[in] segment The name of the segment.
+     *
+     * @param[in] md5sum The MD5 sum of the expected ROS 1 type.
+     *
+     * @param[out] error The reason of the failure, if any.
+     *
+     * @returns The ring, or `nullptr` if the segment does not exist (yet),
+     *          or holds a different type.
+     */
+    static std::unique_ptr<SharedMemoryRing> open(
+            const std::string& segment,
+            const std::string& md5sum,
+            std::string& error);
+
+    ~SharedMemoryRing();
+
+    /**
+     * @brief Serialize a message into the next slot.
+     *
+     * @param[in] msg The message.
+     *
+     * @param[out] handle The handle of the message, to be published to the readers.
+     *
+     * @returns `false` if the serialized message does not fit in a slot.
+     */
+    template<typename Msg>
+    bool write(
+            const Msg& msg,
+            uint64_t& handle)
+    {
+        const uint32_t size = ros::serialization::serializationLength(msg);
+        uint8_t* data = begin_write(size, handle);
+        if (nullptr == data)
+        {
+            return false;
+        }
+
+        ros::serialization::OStream stream(data, size);
+        ros::serialization::serialize(stream, msg);
+
+        end_write(handle);
+        return true;
+    }
+
+    /**
+     * @brief Read the message of a handle.
+     *
+     * @details The slot is copied out to the given buffer before deserializing it,
+     *          so that a concurrent overwrite can never corrupt the deserialization.
+     *          The buffer keeps its capacity between calls.
+     *
+     * @param[in] handle The handle received from the writer.
+     *
+     * @param[in,out] buffer The buffer the slot is copied to.
+     *
+     * @param[out] msg The message.
+     *
+     * @returns The outcome of the read.
+     */
+    template<typename Msg>
+    ReadResult read(
+            uint64_t handle,
+            std::vector<uint8_t>& buffer,
+            Msg& msg) const
+    {
+        const ReadResult result = copy(handle, buffer);
+        if (ReadResult::OK != result)
+        {
+            return result;
+        }
+
+        try
+        {
+            ros::serialization::IStream stream(buffer.data(), static_cast<uint32_t>(buffer.size()));
+            ros::serialization::deserialize(stream, msg);
+        }
+        catch (const ros::serialization::StreamOverrunException&)
+        {
+            return ReadResult::INVALID;
+        }
+
+        return ReadResult::OK;
+    }
+
+    /**
+     * @brief Check whether the segment this ring is attached to was replaced by a new one,
+     *        so that the reader must open it again.
+     *
+     * @param[in] handle A handle received from the writer.
+     *
+     * @returns `true` if the handle belongs to a newer segment with the same name.
+     */
+    bool stale(
+            uint64_t handle) const;
+
+    const std::string& segment() const;
+
+    uint32_t slot_size() const;
+
+private:
+
+    class Implementation;
+
+    SharedMemoryRing(
+            std::unique_ptr<Implementation> pimpl);
+
+    uint8_t* begin_write(
+            uint32_t size,
+            uint64_t& handle);
+
+    void end_write(
+            uint64_t handle);
+
+    ReadResult copy(
+            uint64_t handle,
+            std::vector<uint8_t>& buffer) const;
+
+    std::unique_ptr<Implementation> _pimpl;
+};
+
+/**
+ * @class SharedMemoryReader
+ * @brief The reading end of the shared memory transport of a topic.
+ *
+ * @details The segment is opened with the first handle received, and again whenever
+ *          a handle shows that the writer replaced it. The buffer the slots are copied
+ *          to is kept between reads, so that steady reads allocate nothing.
+ */
+class SharedMemoryReader
+{
+public:
+
+    SharedMemoryReader(
+            const std::string& segment,
+            const std::string& md5sum);
+
+    /**
+     * @brief Make sure that the reader is attached to the segment a handle belongs to.
+     *
+     * @param[in] handle The handle received from the writer.
+     *
+     * @param[out] error The reason why the segment could not be opened, if it fails.
+     *
+     * @returns `false` if the segment could not be opened.
+     */
+    bool attach(
+            uint64_t handle,
+            std::string& error);
+
+    /**
+     * @brief Read the message of a handle, once attached to its segment.
+     *
+     * @see SharedMemoryRing::read
+     */
+    template<typename Msg>
+    SharedMemoryRing::ReadResult read(
+            uint64_t handle,
+            Msg& msg)
+    {
+        return _ring->read(handle, _buffer, msg);
+    }
+
+    const std::string& segment() const;
+
+private:
+
+    const std::string _segment;
+
+    const std::string _md5sum;
+
+    std::unique_ptr<SharedMemoryRing> _ring;
+
+    std::vector<uint8_t> _buffer;
+};
+
+} //  namespace ros1
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
+
+#endif //  _IS_SH_ROS1__INCLUDE__SHAREDMEMORY_HPP_
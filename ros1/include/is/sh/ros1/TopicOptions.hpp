@@ -0,0 +1,317 @@
+/*
+ * Copyright (C) 2020 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _IS_SH_ROS1__INCLUDE__TOPICOPTIONS_HPP_
+#define _IS_SH_ROS1__INCLUDE__TOPICOPTIONS_HPP_
+
+#include <yaml-cpp/yaml.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace ros1 {
+
+/**
+ * @struct DeliveryOptions
+ * @brief How the messages of a topic are handed over, as set by its `delivery` option.
+ */
+struct DeliveryOptions
+{
+    enum class Mode
+    {
+        /// Every message is handed over as soon as it arrives.
+        EACH,
+
+        /// The messages are collected and handed over together, once `max_messages`
+        /// of them are pending or every `period_ms`, whichever comes first.
+        BATCH,
+
+        /// Only the newest message is kept, and handed over every `period_ms`.
+        LATEST
+    };
+
+    Mode mode = Mode::EACH;
+
+    std::size_t max_messages = 64;
+
+    uint32_t period_ms = 10;
+
+    /**
+     * @brief Parse the `delivery` option of a topic.
+     *
+     * @param[in] configuration The `delivery` node. If it is not defined,
+     *            the messages are handed over one by one.
+     *
+     * @param[out] options The parsed options.
+     *
+     * @param[out] error The reason of the failure, if any.
+     *
+     * @returns `true` if the configuration is valid, `false` otherwise.
+     */
+    static bool parse(
+            const YAML::Node& configuration,
+            DeliveryOptions& options,
+            std::string& error)
+    {
+        options = DeliveryOptions();
+        if (!configuration)
+        {
+            return true;
+        }
+
+        const std::string mode = configuration["mode"].as<std::string>("each");
+        if (mode == "each")
+        {
+            options.mode = Mode::EACH;
+        }
+        else if (mode == "batch")
+        {
+            options.mode = Mode::BATCH;
+        }
+        else if (mode == "latest")
+        {
+            options.mode = Mode::LATEST;
+            options.period_ms = 100;
+        }
+        else
+        {
+            error = "unknown delivery mode '" + mode + "'. Supported modes are "
+                    "'each', 'batch' and 'latest'";
+            return false;
+        }
+
+        options.max_messages = configuration["max_messages"].as<std::size_t>(options.max_messages);
+        options.period_ms = configuration["period_ms"].as<uint32_t>(options.period_ms);
+
+        if (Mode::BATCH == options.mode && 0 == options.max_messages)
+        {
+            error = "'max_messages' must be greater than zero";
+            return false;
+        }
+
+        if (Mode::EACH != options.mode && 0 == options.period_ms)
+        {
+            error = "'period_ms' must be greater than zero";
+            return false;
+        }
+
+        return true;
+    }
+};
+
+/**
+ * @struct OverflowOptions
+ * @brief The bridge-side queue of a topic, as set by its `overflow_policy` and `queue_size` options.
+ */
+struct OverflowOptions
+{
+    enum class Policy
+    {
+        /// Make room for the new message by dropping the oldest one.
+        DROP_OLDEST,
+
+        /// Drop the new message.
+        DROP_NEWEST,
+
+        /// Wait for the queue to make room for the new message.
+        BLOCK
+    };
+
+    /// Whether the topic has a bridge-side queue at all.
+    bool enabled = false;
+
+    Policy policy = Policy::DROP_OLDEST;
+
+    std::size_t capacity = 10;
+
+    /**
+     * @brief Parse the overflow options of a topic.
+     *
+     * @param[in] configuration The topic configuration. If `overflow_policy` is not defined,
+     *            there is no bridge-side queue.
+     *
+     * @param[out] options The parsed options.
+     *
+     * @param[out] error The reason of the failure, if any.
+     *
+     * @returns `true` if the configuration is valid, `false` otherwise.
+     */
+    static bool parse(
+            const YAML::Node& configuration,
+            OverflowOptions& options,
+            std::string& error)
+    {
+        options = OverflowOptions();
+
+        const YAML::Node policy = configuration["overflow_policy"];
+        if (!policy)
+        {
+            return true;
+        }
+
+        static const char* const supported =
+            "Supported policies are 'drop_oldest', 'drop_newest' and 'block'";
+
+        if (!policy.IsScalar())
+        {
+            error = std::string("the overflow policy must be a string. ") + supported;
+            return false;
+        }
+
+        const std::string name = policy.Scalar();
+        if (name == "drop_oldest")
+        {
+            options.policy = Policy::DROP_OLDEST;
+        }
+        else if (name == "drop_newest")
+        {
+            options.policy = Policy::DROP_NEWEST;
+        }
+        else if (name == "block")
+        {
+            options.policy = Policy::BLOCK;
+        }
+        else
+        {
+            error = "unknown overflow policy '" + name + "'. " + supported;
+            return false;
+        }
+
+        options.enabled = true;
+        options.capacity = configuration["queue_size"].as<std::size_t>(options.capacity);
+        if (0 == options.capacity)
+        {
+            error = "the 'queue_size' must be greater than zero to apply an overflow policy";
+            return false;
+        }
+
+        return true;
+    }
+};
+
+/**
+ * @struct SharedMemoryOptions
+ * @brief The shared memory transport settings of a topic, as set by its `shared_memory` option.
+ */
+struct SharedMemoryOptions
+{
+    /// Whether the topic uses the shared memory transport at all.
+    bool enabled = false;
+
+    /// The name of the shared memory segment. If empty, it is made from the topic name.
+    std::string segment;
+
+    /// The number of slots of the ring. Only used by the writer that creates the segment.
+    uint32_t slots = 8;
+
+    /// The maximum serialized size of a message. Only used by the writer that creates the segment.
+    uint32_t slot_size = 4 * 1024 * 1024;
+
+    /**
+     * @brief Parse the `shared_memory` option of a topic.
+     *
+     * @param[in] configuration The `shared_memory` node. If it is not defined,
+     *            the topic does not use shared memory.
+     *
+     * @param[out] options The parsed options.
+     *
+     * @param[out] error The reason of the failure, if any.
+     *
+     * @returns `true` if the configuration is valid, `false` otherwise.
+     */
+    static bool parse(
+            const YAML::Node& configuration,
+            SharedMemoryOptions& options,
+            std::string& error);
+
+    /**
+     * @brief Get the options of a given topic, with its segment name filled in.
+     *
+     * @details Unless set explicitly, the segment name is made from the topic name,
+     *          so that both ends agree on it. The options are parsed once for a topic
+     *          name with runtime substitutions, and each of its expansions gets its own
+     *          segment.
+     *
+     * @param[in] topic_name The name of the bridged topic.
+     *
+     * @returns A copy of these options, whose `segment` is never empty.
+     */
+    SharedMemoryOptions for_topic(
+            const std::string& topic_name) const;
+
+    /**
+     * @brief Get the name of the topic carrying the handles of the messages of a topic.
+     *
+     * @param[in] topic_name The name of the bridged topic.
+     *
+     * @returns The handle topic name, that is, `<topic_name>/shm_handle`.
+     */
+    static std::string handle_topic(
+            const std::string& topic_name)
+    {
+        return topic_name + "/shm_handle";
+    }
+};
+
+/**
+ * @struct TopicOptions
+ * @brief The bridge-side options of a topic, besides the ones roscpp takes care of.
+ *
+ * @details They are parsed and validated once by the SystemHandle, and then handed over
+ *          to the publisher and subscription builders registered in the Factory.
+ */
+struct TopicOptions
+{
+    DeliveryOptions delivery;
+
+    OverflowOptions overflow;
+
+    SharedMemoryOptions shared_memory;
+
+    /// The number of messages kept for the late-joining subscribers, or zero if the topic keeps no history.
+    std::size_t history_depth = 0;
+
+    /// Whether the converted messages are shared with the rest of the ROS 1 publishers of the same type.
+    bool fanout_cache = false;
+
+    /**
+     * @brief Parse the options of a topic.
+     *
+     * @param[in] configuration The topic configuration.
+     *
+     * @param[out] options The parsed options.
+     *
+     * @param[out] error The reason of the failure, if any, naming the offending option.
+     *
+     * @returns `true` if the configuration is valid, `false` otherwise.
+     */
+    static bool parse(
+            const YAML::Node& configuration,
+            TopicOptions& options,
+            std::string& error);
+};
+
+} //  namespace ros1
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
+
+#endif //  _IS_SH_ROS1__INCLUDE__TOPICOPTIONS_HPP_
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2020 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _IS_SH_ROS1__INCLUDE__TRACING_HPP_
+#define _IS_SH_ROS1__INCLUDE__TRACING_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#ifdef IS_ROS1_TRACEPOINTS
+#  include <sys/sdt.h>
+#endif //  IS_ROS1_TRACEPOINTS
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace ros1 {
+
+/**
+ * @class TraceContext
+ * @brief Identifies the messages of a topic or service in its tracepoints.
+ *
+ * @details Every tracepoint carries the name of the topic or service, a numeric identifier
+ *          derived from it, and the sequence number of the message or call within the entity,
+ *          so that the stages a given message goes through can be told apart under load.
+ */
+class TraceContext
+{
+public:
+
+    explicit TraceContext(
+            const std::string& name)
+        : _name(name)
+        , _id(static_cast<uint64_t>(std::hash<std::string>()(name)))
+    {
+    }
+
+    const char* name() const
+    {
+        return _name.c_str();
+    }
+
+    uint64_t id() const
+    {
+        return _id;
+    }
+
+    /**
+     * @brief Get the sequence number of a new message or call.
+     */
+    uint64_t next()
+    {
+        return _sequence.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+private:
+
+    const std::string _name;
+    const uint64_t _id;
+    std::atomic<uint64_t> _sequence{0};
+};
+
+/**
+ * @class NullTraceContext
+ * @brief Stands for TraceContext when the tracepoints are not compiled, so that the
+ *        entities do not carry the name and counters nothing reads.
+ *
+ * @details It has a name of its own because `IS_ROS1_TRACEPOINTS` may be defined for
+ *          some type support libraries and not for others.
+ */
+class NullTraceContext
+{
+public:
+
+    explicit NullTraceContext(
+            const std::string& /*name*/)
+    {
+    }
+};
+
+#ifndef IS_ROS1_TRACEPOINTS
+using EntityTraceContext = NullTraceContext;
+#else
+using EntityTraceContext = TraceContext;
+#endif //  IS_ROS1_TRACEPOINTS
+
+} //  namespace ros1
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
+
+/**
+ * @brief Start tracing a message or service call: take its sequence number and hit
+ *        the first tracepoint of its span.
+ *
+ * @details The tracepoints are USDT probes of the `is_ros1` provider, which perf, bpftrace,
+ *          SystemTap and LTTng can attach to. They are only compiled if `IS_ROS1_TRACEPOINTS`
+ *          is defined; otherwise, no probes remain and the sequence number is always `0`.
+ *          A probe that nothing is attached to costs a single `nop` instruction.
+ *
+ * @param[in] probe The name of the tracepoint.
+ *
+ * @param[in] context The EntityTraceContext of the entity.
+ *
+ * @param[in] sequence The name of the variable declared to hold the sequence number,
+ *            to be passed to the rest of the tracepoints of the span.
+ */
+#ifdef IS_ROS1_TRACEPOINTS
+#  define IS_ROS1_TRACE_BEGIN(probe, context, sequence) \
+    const uint64_t sequence = (context).next(); \
+    DTRACE_PROBE3(is_ros1, probe, (context).name(), (context).id(), sequence)
+#else
+#  define IS_ROS1_TRACE_BEGIN(probe, context, sequence) \
+    const uint64_t sequence = 0; \
+    (void)sequence
+#endif //  IS_ROS1_TRACEPOINTS
+
+/**
+ * @brief Hit a tracepoint of the span of a message or service call.
+ *
+ * @param[in] probe The name of the tracepoint.
+ *
+ * @param[in] context The EntityTraceContext of the entity.
+ *
+ * @param[in] sequence The sequence number taken by IS_ROS1_TRACE_BEGIN.
+ */
+#ifdef IS_ROS1_TRACEPOINTS
+#  define IS_ROS1_TRACE(probe, context, sequence) \
+    DTRACE_PROBE3(is_ros1, probe, (context).name(), (context).id(), sequence)
+#else
+#  define IS_ROS1_TRACE(probe, context, sequence) \
+    (void)(sequence)
+#endif //  IS_ROS1_TRACEPOINTS
+
+#endif //  _IS_SH_ROS1__INCLUDE__TRACING_HPP_
@@ -27,6 +27,10 @@
 
 #include <boost/array.hpp>
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 namespace eprosima {
 namespace is {
 namespace sh {
@@ -42,6 +46,11 @@ namespace ros1 {
 
 namespace convert__msg__Timebase {
 
+// Member indices of the Time and Duration types, used by the converters below
+// to access the members without looking them up by name.
+constexpr std::size_t sec_index = 0;
+constexpr std::size_t nanosec_index = 1;
+
 //==============================================================================
 inline const xtypes::StructType type(
         const std::string& name)
@@ -63,8 +72,8 @@ inline void convert_to_ros1(
 {
     int32_t to_sec;
     uint32_t to_nsec;
-    is::utils::Convert<int32_t>::from_xtype_field(from["sec"], to_sec);
-    is::utils::Convert<uint32_t>::from_xtype_field(from["nanosec"], to_nsec);
+    is::utils::Convert<int32_t>::from_xtype_field(from[convert__msg__Timebase::sec_index], to_sec);
+    is::utils::Convert<uint32_t>::from_xtype_field(from[convert__msg__Timebase::nanosec_index], to_nsec);
     to.nsec = to_nsec;
     to.sec = static_cast<uint32_t>(to_sec);
 }
@@ -74,8 +83,8 @@ inline void convert_to_xtype(
         const ros::Time& from,
         xtypes::WritableDynamicDataRef to)
 {
-    is::utils::Convert<int32_t>::to_xtype_field(from.sec, to["sec"]);
-    is::utils::Convert<uint32_t>::to_xtype_field(static_cast<uint32_t>(from.nsec), to["nanosec"]);
+    is::utils::Convert<int32_t>::to_xtype_field(from.sec, to[convert__msg__Timebase::sec_index]);
+    is::utils::Convert<uint32_t>::to_xtype_field(static_cast<uint32_t>(from.nsec), to[convert__msg__Timebase::nanosec_index]);
 }
 
 } //  namespace convert__msg__Time
@@ -89,8 +98,8 @@ inline void convert_to_ros1(
 {
     int32_t to_sec;
     uint32_t to_nsec;
-    is::utils::Convert<int32_t>::from_xtype_field(from["sec"], to_sec);
-    is::utils::Convert<uint32_t>::from_xtype_field(from["nanosec"], to_nsec);
+    is::utils::Convert<int32_t>::from_xtype_field(from[convert__msg__Timebase::sec_index], to_sec);
+    is::utils::Convert<uint32_t>::from_xtype_field(from[convert__msg__Timebase::nanosec_index], to_nsec);
     to.sec = to_sec;
     to.nsec = static_cast<int32_t>(to_nsec);
 }
@@ -112,12 +121,94 @@ inline void convert_to_xtype(
     {
         nanosec = static_cast<uint32_t>(from.nsec);
     }
-    is::utils::Convert<int32_t>::to_xtype_field(sec, to["sec"]);
-    is::utils::Convert<uint32_t>::to_xtype_field(nanosec, to["nanosec"]);
+    is::utils::Convert<int32_t>::to_xtype_field(sec, to[convert__msg__Timebase::sec_index]);
+    is::utils::Convert<uint32_t>::to_xtype_field(nanosec, to[convert__msg__Timebase::nanosec_index]);
 }
 
 } //  namespace convert__msg__Duration
 
+// xTypes sequences do not shrink when resized, and the generated converters refill the same
+// DynamicData instance for every message; so every sequence member is emptied first whenever
+// the new message has fewer elements than the one it is converted over.
+namespace convert__sequence {
+
+//==============================================================================
+inline void shrink(
+        xtypes::WritableDynamicDataRef to,
+        std::size_t size)
+{
+    if (to.size() > size)
+    {
+        to = xtypes::DynamicData(to.type());
+    }
+}
+
+} //  namespace convert__sequence
+
+// Sequences of fixed-width primitives share the same memory layout in ROS 1 and
+// in xTypes, so they are converted as a whole with a single block copy, instead
+// of going element by element through is::utils::Convert. The generated converters
+// use these functions for every integer and floating point array member.
+namespace convert__primitive_sequence {
+
+//==============================================================================
+template<typename T, typename Allocator>
+inline void convert_to_ros1(
+        const xtypes::ReadableDynamicDataRef& from,
+        std::vector<T, Allocator>& to)
+{
+    const std::size_t size = from.size();
+    to.resize(size);
+    if (0 < size)
+    {
+        std::memcpy(to.data(), &from[0].value<T>(), size * sizeof(T));
+    }
+}
+
+//==============================================================================
+template<typename T, std::size_t N>
+inline void convert_to_ros1(
+        const xtypes::ReadableDynamicDataRef& from,
+        boost::array<T, N>& to)
+{
+    const std::size_t size = std::min(from.size(), N);
+    if (0 < size)
+    {
+        std::memcpy(to.data(), &from[0].value<T>(), size * sizeof(T));
+    }
+    std::fill(to.begin() + size, to.end(), T());
+}
+
+//==============================================================================
+template<typename T>
+inline T* resize(
+        xtypes::WritableDynamicDataRef to,
+        std::size_t size)
+{
+    convert__sequence::shrink(to, size);
+
+    to.resize(size);
+    return (0 < size) ? const_cast<T*>(&to[0].value<T>()) : nullptr;
+}
+
+//==============================================================================
+template<typename Container>
+inline void convert_to_xtype(
+        const Container& from,
+        xtypes::WritableDynamicDataRef to)
+{
+    using T = typename Container::value_type;
+
+    const std::size_t size = from.size();
+    T* data = resize<T>(to, size);
+    if (0 < size)
+    {
+        std::memcpy(data, from.data(), size * sizeof(T));
+    }
+}
+
+} //  namespace convert__primitive_sequence
+
 } //  namespace ros1
 } //  namespace sh
 
@@ -0,0 +1,194 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# Copyright (C) 2020 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Run an Integration Service configuration as several Integration Service processes,
+each of them bridging a shard of its topics and services.
+
+Each topic and service is assigned to a shard by hashing its name, so that it always
+lands on the same shard as long as the number of shards does not change. Every shard
+gets its own ROS 1 node, with its own connections and XML-RPC server, and its own
+connections on the other side of the bridge.
+"""
+
+from __future__ import print_function
+
+import argparse
+import copy
+import os
+import signal
+import subprocess
+import sys
+import tempfile
+import time
+import zlib
+
+try:
+    import yaml
+except ImportError:
+    print('Unable to import PyYAML. Please install it first.', file=sys.stderr)
+    sys.exit(1)
+
+
+def shard_of(name, shards):
+    return zlib.crc32(name.encode('utf-8')) % shards
+
+
+def make_shard_configuration(configuration, shard, shards):
+    shard_configuration = copy.deepcopy(configuration)
+    entities = 0
+
+    for section in ('topics', 'services'):
+        if section not in configuration:
+            continue
+
+        # The name of a topic or service may be remapped per system, but its key is unique.
+        selected = {
+            name: entity for name, entity in configuration[section].items()
+            if shard_of(name, shards) == shard
+        }
+
+        entities += len(selected)
+        if selected:
+            shard_configuration[section] = selected
+        else:
+            del shard_configuration[section]
+
+    for system in shard_configuration.get('systems', {}).values():
+        if system.get('type') == 'ros1':
+            node_name = system.get('node_name', 'is_ros1_node_')
+            system['node_name'] = '{}_shard{}'.format(node_name.rstrip('_'), shard)
+
+    return shard_configuration, entities
+
+
+class Shard(object):
+
+    def __init__(self, index, configuration_file, executable):
+        self.index = index
+        self.configuration_file = configuration_file
+        self.executable = executable
+        self.process = None
+        self.restarts = 0
+
+    def start(self):
+        print('Starting shard {} with {}'.format(self.index, self.configuration_file))
+        self.process = subprocess.Popen([self.executable, self.configuration_file])
+
+    def stop(self, sig):
+        if self.process is not None and self.process.poll() is None:
+            self.process.send_signal(sig)
+
+
+def main(argv=sys.argv[1:]):
+    parser = argparse.ArgumentParser(
+        description='Run an Integration Service configuration as several Integration Service '
+                    'processes, each of them bridging a shard of its topics and services.')
+    parser.add_argument('configuration', help='The Integration Service YAML configuration file')
+    parser.add_argument('-n', '--shards', type=int, required=True, help='The number of shards')
+    parser.add_argument(
+        '-o', '--output-dir',
+        help='The directory where the configuration file of each shard is written. '
+             'Defaults to a temporary directory')
+    parser.add_argument(
+        '-e', '--executable', default='integration-service',
+        help='The Integration Service executable. Defaults to integration-service')
+    parser.add_argument(
+        '-r', '--restart', action='store_true',
+        help='Start again the shards that exit while the supervisor is running')
+    parser.add_argument(
+        '--dry-run', action='store_true',
+        help='Only write the configuration file of each shard, without running them')
+    args = parser.parse_args(argv)
+
+    if args.shards < 1:
+        parser.error('the number of shards must be greater than zero')
+
+    with open(args.configuration) as f:
+        configuration = yaml.safe_load(f)
+
+    output_dir = args.output_dir or tempfile.mkdtemp(prefix='is_ros1_shards_')
+    if not os.path.isdir(output_dir):
+        os.makedirs(output_dir)
+
+    base_name = os.path.splitext(os.path.basename(args.configuration))[0]
+    shards = []
+    for index in range(args.shards):
+        shard_configuration, entities = make_shard_configuration(configuration, index, args.shards)
+        if entities == 0:
+            print('Shard {} has no topics nor services, skipping it'.format(index))
+            continue
+
+        configuration_file = os.path.join(output_dir, '{}.shard{}.yaml'.format(base_name, index))
+        with open(configuration_file, 'w') as f:
+            yaml.safe_dump(shard_configuration, f, default_flow_style=False)
+
+        print('Shard {}: {} topics and services'.format(index, entities))
+        shards.append(Shard(index, configuration_file, args.executable))
+
+    if args.dry_run or not shards:
+        return 0
+
+    stopping = []
+
+    def on_signal(sig, frame):
+        stopping.append(sig)
+        for shard in shards:
+            shard.stop(sig)
+
+    signal.signal(signal.SIGINT, on_signal)
+    signal.signal(signal.SIGTERM, on_signal)
+
+    for shard in shards:
+        shard.start()
+
+    exit_code = 0
+    while True:
+        running = 0
+        for shard in shards:
+            if shard.process is None:
+                continue
+
+            returncode = shard.process.poll()
+            if returncode is None:
+                running += 1
+                continue
+
+            if not stopping and args.restart:
+                shard.restarts += 1
+                print('Shard {} exited with code {}, starting it again (restart {})'.format(
+                    shard.index, returncode, shard.restarts), file=sys.stderr)
+
+                # Back off, so that a shard failing at startup does not spin.
+                time.sleep(min(shard.restarts, 10))
+                shard.start()
+                running += 1
+            else:
+                if returncode != 0 and not stopping:
+                    print('Shard {} exited with code {}'.format(shard.index, returncode),
+                          file=sys.stderr)
+                    exit_code = returncode
+                shard.process = None
+
+        if running == 0:
+            return exit_code
+
+        time.sleep(0.5)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2020 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <is/sh/ros1/Delivery.hpp>
+
+#include <ros/node_handle.h>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace ros1 {
+
+//==============================================================================
+DeliveryBuffer::DeliveryBuffer(
+        ros::NodeHandle& node,
+        const DeliveryOptions& options,
+        Handler handler)
+    : _options(options)
+    , _handler(std::move(handler))
+{
+    if (DeliveryOptions::Mode::BATCH == _options.mode)
+    {
+        _pending.reserve(_options.max_messages);
+    }
+
+    if (DeliveryOptions::Mode::EACH != _options.mode)
+    {
+        _timer = node.createWallTimer(
+            ros::WallDuration(_options.period_ms / 1000.0),
+            &DeliveryBuffer::on_timer, this);
+    }
+}
+
+//==============================================================================
+DeliveryBuffer::~DeliveryBuffer()
+{
+    _timer.stop();
+}
+
+//==============================================================================
+void DeliveryBuffer::push(
+        const MsgConstPtr& msg)
+{
+    if (DeliveryOptions::Mode::EACH == _options.mode)
+    {
+        std::lock_guard<std::mutex> lock(_delivery_mutex);
+        _handler(msg);
+        return;
+    }
+
+    bool full = false;
+    {
+        std::lock_guard<std::mutex> lock(_pending_mutex);
+        if (DeliveryOptions::Mode::LATEST == _options.mode)
+        {
+            _pending.clear();
+        }
+
+        _pending.push_back(msg);
+        full = DeliveryOptions::Mode::BATCH == _options.mode
+                && _pending.size() >= _options.max_messages;
+    }
+
+    if (full)
+    {
+        flush();
+    }
+}
+
+//==============================================================================
+void DeliveryBuffer::flush()
+{
+    std::lock_guard<std::mutex> delivery_lock(_delivery_mutex);
+    {
+        std::lock_guard<std::mutex> lock(_pending_mutex);
+        _delivering.swap(_pending);
+    }
+
+    for (const MsgConstPtr& msg : _delivering)
+    {
+        _handler(msg);
+    }
+
+    // Both buffers keep their capacity, so that steady batches allocate nothing.
+    _delivering.clear();
+}
+
+//==============================================================================
+void DeliveryBuffer::on_timer(
+        const ros::WallTimerEvent& /*event*/)
+{
+    flush();
+}
+
+} //  namespace ros1
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
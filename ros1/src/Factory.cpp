@@ -20,7 +20,12 @@
 
 #include <is/utils/Log.hpp>
 
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
 #include <unordered_map>
+#include <vector>
 
 namespace eprosima {
 namespace is {
@@ -33,22 +38,36 @@ class Factory::Implementation
 public:
 
     Implementation()
-        : logger_("is::sh::ROS1::Factory")
+        : _segments{}
+        , logger_("is::sh::ROS1::Factory")
     {
     }
 
-    void register_type_factory(
+    TypeId type_id(
+            const std::string& type_name) const
+    {
+        std::shared_lock<std::shared_mutex> lock(_ids_mutex);
+        const auto it = _ids.find(type_name);
+        return (it == _ids.end()) ? invalid_type_id : it->second;
+    }
+
+    TypeId register_type_factory(
             const std::string& type_name,
             RegisterTypeToFactory register_type_func)
     {
-        _type_factories[type_name] = std::move(register_type_func);
+        const TypeId id = register_builder(type_name, &Builders::type, std::move(register_type_func));
+
+        std::unique_lock<std::mutex> lock(_types_mutex);
+        _types.erase(id);
+        return id;
     }
 
     xtypes::DynamicType::Ptr create_type(
             const std::string& type_name)
     {
-        auto it = _type_factories.find(type_name);
-        if (it == _type_factories.end())
+        const TypeId id = type_id(type_name);
+        const Builders* builders = find(id);
+        if (nullptr == builders || !builders->type)
         {
             logger_ << utils::Logger::Level::ERROR
                     << "'create_type' could not find a factory type named '"
@@ -57,14 +76,25 @@ public:
             return xtypes::DynamicType::Ptr();
         }
 
-        return it->second();
+        std::unique_lock<std::mutex> lock(_types_mutex);
+
+        // Types are immutable once built, so all the users of a type share the same instance.
+        const auto cached = _types.find(id);
+        if (cached != _types.end())
+        {
+            return cached->second;
+        }
+
+        xtypes::DynamicType::Ptr type = builders->type();
+        _types.emplace(id, type);
+        return type;
     }
 
-    void register_subscription_factory(
+    TypeId register_subscription_factory(
             const std::string& topic_type,
             RegisterSubscriptionToFactory register_sub_func)
     {
-        _subscription_factories[topic_type] = std::move(register_sub_func);
+        return register_builder(topic_type, &Builders::subscription, std::move(register_sub_func));
     }
 
     std::shared_ptr<void> create_subscription(
@@ -73,10 +103,11 @@ public:
             const std::string& topic_name,
             TopicSubscriberSystem::SubscriptionCallback* callback,
             uint32_t queue_size,
-            const ros::TransportHints& transport_hints)
+            const ros::TransportHints& transport_hints,
+            const TopicOptions& options)
     {
-        auto it = _subscription_factories.find(topic_type.name());
-        if (it == _subscription_factories.end())
+        const Builders* builders = find(type_id(topic_type.name()));
+        if (nullptr == builders || !builders->subscription)
         {
             logger_ << utils::Logger::Level::ERROR
                     << "create_subscription' could not find a message type named '"
@@ -85,15 +116,37 @@ public:
             return nullptr;
         }
 
-        return it->second(node, topic_name, topic_type, callback,
-                       queue_size, transport_hints);
+        return builders->subscription(node, topic_name, topic_type, callback,
+                       queue_size, transport_hints, options);
     }
 
-    void register_publisher_factory(
+    TypeId register_publisher_factory(
             const std::string& topic_type,
             RegisterPublisherToFactory register_pub_func)
     {
-        _publisher_factories[topic_type] = std::move(register_pub_func);
+        return register_builder(topic_type, &Builders::publisher, std::move(register_pub_func));
+    }
+
+    std::shared_ptr<TopicPublisher> create_publisher(
+            TypeId topic_type_id,
+            ros::NodeHandle& node,
+            const std::string& topic_name,
+            uint32_t queue_size,
+            bool latch,
+            const TopicOptions& options)
+    {
+        const Builders* builders = find(topic_type_id);
+        if (nullptr == builders || !builders->publisher)
+        {
+            logger_ << utils::Logger::Level::ERROR
+                    << "'create_publisher': could not find a message type named '"
+                    << (builders ? builders->name : std::string("<unknown>"))
+                    << "' to load!" << std::endl;
+
+            return nullptr;
+        }
+
+        return builders->publisher(node, topic_name, queue_size, latch, options);
     }
 
     std::shared_ptr<TopicPublisher> create_publisher(
@@ -101,10 +154,11 @@ public:
             ros::NodeHandle& node,
             const std::string& topic_name,
             uint32_t queue_size,
-            bool latch)
+            bool latch,
+            const TopicOptions& options)
     {
-        auto it = _publisher_factories.find(topic_type.name());
-        if (it == _publisher_factories.end())
+        const TypeId id = type_id(topic_type.name());
+        if (invalid_type_id == id)
         {
             logger_ << utils::Logger::Level::ERROR
                     << "'create_publisher': could not find a message type named '"
@@ -113,24 +167,26 @@ public:
             return nullptr;
         }
 
-        return it->second(node, topic_name, queue_size, latch);
+        return create_publisher(id, node, topic_name, queue_size, latch, options);
     }
 
-    void register_client_proxy_factory(
+    TypeId register_client_proxy_factory(
             const std::string& service_response_type,
             RegisterServiceClientToFactory register_service_client_func)
     {
-        _client_proxy_factories[service_response_type] = std::move(register_service_client_func);
+        return register_builder(
+            service_response_type, &Builders::client_proxy, std::move(register_service_client_func));
     }
 
     std::shared_ptr<ServiceClient> create_client_proxy(
             const std::string& service_response_type,
             ros::NodeHandle& node,
             const std::string& service_name,
-            ServiceClientSystem::RequestCallback* callback)
+            ServiceClientSystem::RequestCallback* callback,
+            const YAML::Node& configuration)
     {
-        auto it = _client_proxy_factories.find(service_response_type);
-        if (it == _client_proxy_factories.end())
+        const Builders* builders = find(type_id(service_response_type));
+        if (nullptr == builders || !builders->client_proxy)
         {
             logger_ << utils::Logger::Level::ERROR
                     << "'create_client_proxy': could not find a service type named '"
@@ -139,23 +195,25 @@ public:
             return nullptr;
         }
 
-        return it->second(node, service_name, callback);
+        return builders->client_proxy(node, service_name, callback, configuration);
     }
 
-    void register_server_proxy_factory(
+    TypeId register_server_proxy_factory(
             const std::string& service_request_type,
             RegisterServiceProviderToFactory register_service_server_func)
     {
-        _server_proxy_factories[service_request_type] = std::move(register_service_server_func);
+        return register_builder(
+            service_request_type, &Builders::server_proxy, std::move(register_service_server_func));
     }
 
     std::shared_ptr<ServiceProvider> create_server_proxy(
             const std::string& service_request_type,
             ros::NodeHandle& node,
-            const std::string& service_name)
+            const std::string& service_name,
+            const YAML::Node& configuration)
     {
-        auto it = _server_proxy_factories.find(service_request_type);
-        if (it == _server_proxy_factories.end())
+        const Builders* builders = find(type_id(service_request_type));
+        if (nullptr == builders || !builders->server_proxy)
         {
             logger_ << utils::Logger::Level::ERROR
                     << "'create_server_proxy': could not find a service type named '"
@@ -164,16 +222,105 @@ public:
             return nullptr;
         }
 
-        return it->second(node, service_name);
+        return builders->server_proxy(node, service_name, configuration);
     }
 
 private:
 
-    std::unordered_map<std::string, RegisterTypeToFactory> _type_factories;
-    std::unordered_map<std::string, RegisterSubscriptionToFactory> _subscription_factories;
-    std::unordered_map<std::string, RegisterPublisherToFactory> _publisher_factories;
-    std::unordered_map<std::string, RegisterServiceClientToFactory> _client_proxy_factories;
-    std::unordered_map<std::string, RegisterServiceProviderToFactory> _server_proxy_factories;
+    /**
+     * Every builder registered for a type name. Once published in the table,
+     * an instance is never modified: registering a new builder publishes a copy.
+     */
+    struct Builders
+    {
+        std::string name;
+        RegisterTypeToFactory type;
+        RegisterSubscriptionToFactory subscription;
+        RegisterPublisherToFactory publisher;
+        RegisterServiceClientToFactory client_proxy;
+        RegisterServiceProviderToFactory server_proxy;
+    };
+
+    static constexpr std::size_t segment_size = 256;
+    static constexpr std::size_t max_segments = 1024;
+
+    struct Segment
+    {
+        std::array<std::atomic<const Builders*>, segment_size> slots{};
+    };
+
+    /**
+     * Lookups by id take no lock: the table is made of fixed size segments that
+     * never move once allocated, and each slot is swapped atomically on registration.
+     */
+    const Builders* find(
+            TypeId id) const
+    {
+        if (id >= segment_size * max_segments)
+        {
+            return nullptr;
+        }
+
+        const Segment* segment = _segments[id / segment_size].load(std::memory_order_acquire);
+        return segment ? segment->slots[id % segment_size].load(std::memory_order_acquire) : nullptr;
+    }
+
+    template<typename Builder>
+    TypeId register_builder(
+            const std::string& type_name,
+            Builder Builders::* member,
+            Builder builder)
+    {
+        std::unique_lock<std::shared_mutex> lock(_ids_mutex);
+
+        auto it = _ids.find(type_name);
+        if (it == _ids.end())
+        {
+            const TypeId id = static_cast<TypeId>(_ids.size());
+            if (id >= segment_size * max_segments)
+            {
+                logger_ << utils::Logger::Level::ERROR
+                        << "Could not register '" << type_name << "': the factory is full" << std::endl;
+
+                return invalid_type_id;
+            }
+
+            std::atomic<Segment*>& segment = _segments[id / segment_size];
+            if (nullptr == segment.load(std::memory_order_relaxed))
+            {
+                _owned_segments.emplace_back(new Segment());
+                segment.store(_owned_segments.back().get(), std::memory_order_release);
+            }
+
+            it = _ids.emplace(type_name, id).first;
+        }
+
+        const TypeId id = it->second;
+        std::atomic<const Builders*>& slot =
+                _segments[id / segment_size].load(std::memory_order_relaxed)->slots[id % segment_size];
+
+        const Builders* current = slot.load(std::memory_order_relaxed);
+        std::unique_ptr<Builders> updated(current ? new Builders(*current) : new Builders());
+        updated->name = type_name;
+        updated->*member = std::move(builder);
+
+        // The replaced instance is kept alive, since a concurrent reader may still hold it.
+        // Only a few builders are registered per type, so this is bounded.
+        slot.store(updated.get(), std::memory_order_release);
+        _owned_builders.emplace_back(std::move(updated));
+
+        return id;
+    }
+
+    std::array<std::atomic<Segment*>, max_segments> _segments;
+
+    mutable std::shared_mutex _ids_mutex;
+    std::unordered_map<std::string, TypeId> _ids;
+    std::vector<std::unique_ptr<Segment> > _owned_segments;
+    std::vector<std::unique_ptr<Builders> > _owned_builders;
+
+    std::mutex _types_mutex;
+    std::unordered_map<TypeId, xtypes::DynamicType::Ptr> _types;
 
     utils::Logger logger_;
 
@@ -187,11 +334,18 @@ Factory& Factory::instance()
 }
 
 //==============================================================================
-void Factory::register_type_factory(
+Factory::TypeId Factory::type_id(
+        const std::string& type_name) const
+{
+    return _pimpl->type_id(type_name);
+}
+
+//==============================================================================
+Factory::TypeId Factory::register_type_factory(
         const std::string& type_name,
         RegisterTypeToFactory register_type_func)
 {
-    _pimpl->register_type_factory(
+    return _pimpl->register_type_factory(
         type_name, std::move(register_type_func));
 }
 
@@ -203,11 +357,11 @@ xtypes::DynamicType::Ptr Factory::create_type(
 }
 
 //==============================================================================
-void Factory::register_subscription_factory(
+Factory::TypeId Factory::register_subscription_factory(
         const std::string& topic_type,
         RegisterSubscriptionToFactory register_sub_func)
 {
-    _pimpl->register_subscription_factory(
+    return _pimpl->register_subscription_factory(
         topic_type, std::move(register_sub_func));
 }
 
@@ -218,19 +372,20 @@ std::shared_ptr<void> Factory::create_subscription(
         const std::string& topic_name,
         TopicSubscriberSystem::SubscriptionCallback* callback,
         uint32_t queue_size,
-        const ros::TransportHints& transport_hints)
+        const ros::TransportHints& transport_hints,
+        const TopicOptions& options)
 {
     return _pimpl->create_subscription(
         topic_type, node, topic_name, callback,
-        queue_size, transport_hints);
+        queue_size, transport_hints, options);
 }
 
 //==============================================================================
-void Factory::register_publisher_factory(
+Factory::TypeId Factory::register_publisher_factory(
         const std::string& topic_type,
         RegisterPublisherToFactory register_pub_func)
 {
-    _pimpl->register_publisher_factory(
+    return _pimpl->register_publisher_factory(
         topic_type, std::move(register_pub_func));
 }
 
@@ -240,18 +395,32 @@ std::shared_ptr<TopicPublisher> Factory::create_publisher(
         ros::NodeHandle& node,
         const std::string& topic_name,
         uint32_t queue_size,
-        bool latch)
+        bool latch,
+        const TopicOptions& options)
+{
+    return _pimpl->create_publisher(
+        topic_type, node, topic_name, queue_size, latch, options);
+}
+
+//==============================================================================
+std::shared_ptr<TopicPublisher> Factory::create_publisher(
+        TypeId topic_type_id,
+        ros::NodeHandle& node,
+        const std::string& topic_name,
+        uint32_t queue_size,
+        bool latch,
+        const TopicOptions& options)
 {
     return _pimpl->create_publisher(
-        topic_type, node, topic_name, queue_size, latch);
+        topic_type_id, node, topic_name, queue_size, latch, options);
 }
 
 //==============================================================================
-void Factory::register_client_proxy_factory(
+Factory::TypeId Factory::register_client_proxy_factory(
         const std::string& service_response_type,
         RegisterServiceClientToFactory register_service_client_func)
 {
-    _pimpl->register_client_proxy_factory(
+    return _pimpl->register_client_proxy_factory(
         service_response_type, std::move(register_service_client_func));
 }
 
@@ -260,18 +429,19 @@ std::shared_ptr<ServiceClient> Factory::create_client_proxy(
         const std::string& service_response_type,
         ros::NodeHandle& node,
         const std::string& service_name,
-        ServiceClientSystem::RequestCallback* callback)
+        ServiceClientSystem::RequestCallback* callback,
+        const YAML::Node& configuration)
 {
     return _pimpl->create_client_proxy(
-        service_response_type, node, service_name, callback);
+        service_response_type, node, service_name, callback, configuration);
 }
 
 //==============================================================================
-void Factory::register_server_proxy_factory(
+Factory::TypeId Factory::register_server_proxy_factory(
         const std::string& service_request_type,
         RegisterServiceProviderToFactory register_service_server_func)
 {
-    _pimpl->register_server_proxy_factory(
+    return _pimpl->register_server_proxy_factory(
         service_request_type, std::move(register_service_server_func));
 }
 
@@ -279,9 +449,10 @@ void Factory::register_server_proxy_factory(
 std::shared_ptr<ServiceProvider> Factory::create_server_proxy(
         const std::string& service_request_type,
         ros::NodeHandle& node,
-        const std::string& service_name)
+        const std::string& service_name,
+        const YAML::Node& configuration)
 {
-    return _pimpl->create_server_proxy(service_request_type, node, service_name);
+    return _pimpl->create_server_proxy(service_request_type, node, service_name, configuration);
 }
 
 //==============================================================================
@@ -22,13 +22,236 @@
 
 #include <is/core/runtime/StringTemplate.hpp>
 
+#include <is/utils/Log.hpp>
+
+#include <chrono>
+#include <list>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 namespace eprosima {
 namespace is {
 namespace sh {
 namespace ros1 {
 
+namespace {
+
+//==============================================================================
+/**
+ * @brief Extracts the fields of a message referenced by a topic template.
+ *
+ * @details The template is parsed once, and every `{message.<field>}` substitution is resolved
+ *          to the member indices that lead to the field, so that each message only needs to
+ *          read those fields, instead of building the whole topic name.
+ *          The extracted values are packed in a binary key, which changes if and only if
+ *          one of the referenced fields changes.
+ *
+ *          If the template contains any substitution that cannot be resolved this way,
+ *          the key is the topic name computed by the core::StringTemplate.
+ */
+class TopicTemplateKey
+{
+public:
+
+    TopicTemplateKey(
+            const std::string& topic_template,
+            const xtypes::DynamicType& message_type)
+        : _compiled(compile(topic_template, message_type))
+    {
+    }
+
+    bool compiled() const
+    {
+        return _compiled;
+    }
+
+    void compute(
+            const xtypes::DynamicData& message,
+            std::string& key) const
+    {
+        key.clear();
+
+        for (const Field& field : _fields)
+        {
+            append_field(field, 0, message, key);
+        }
+    }
+
+private:
+
+    struct Field
+    {
+        std::vector<std::size_t> path;
+        xtypes::TypeKind kind;
+    };
+
+    static void append_field(
+            const Field& field,
+            std::size_t depth,
+            const xtypes::ReadableDynamicDataRef& data,
+            std::string& key)
+    {
+        if (depth == field.path.size())
+        {
+            append(field.kind, data, key);
+        }
+        else
+        {
+            append_field(field, depth + 1, data[field.path[depth]], key);
+        }
+    }
+
+    template<typename T>
+    static void append_value(
+            const xtypes::ReadableDynamicDataRef& data,
+            std::string& key)
+    {
+        const T value = data.value<T>();
+        key.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    static void append(
+            xtypes::TypeKind kind,
+            const xtypes::ReadableDynamicDataRef& data,
+            std::string& key)
+    {
+        switch (kind)
+        {
+            case xtypes::TypeKind::BOOLEAN_TYPE: append_value<bool>(data, key); break;
+            case xtypes::TypeKind::CHAR_8_TYPE: append_value<char>(data, key); break;
+            case xtypes::TypeKind::UINT_8_TYPE: append_value<uint8_t>(data, key); break;
+            case xtypes::TypeKind::INT_16_TYPE: append_value<int16_t>(data, key); break;
+            case xtypes::TypeKind::UINT_16_TYPE: append_value<uint16_t>(data, key); break;
+            case xtypes::TypeKind::INT_32_TYPE: append_value<int32_t>(data, key); break;
+            case xtypes::TypeKind::UINT_32_TYPE: append_value<uint32_t>(data, key); break;
+            case xtypes::TypeKind::INT_64_TYPE: append_value<int64_t>(data, key); break;
+            case xtypes::TypeKind::UINT_64_TYPE: append_value<uint64_t>(data, key); break;
+            case xtypes::TypeKind::FLOAT_32_TYPE: append_value<float>(data, key); break;
+            case xtypes::TypeKind::FLOAT_64_TYPE: append_value<double>(data, key); break;
+            case xtypes::TypeKind::STRING_TYPE:
+            {
+                // The length prefix keeps the key unambiguous for consecutive strings.
+                const std::string& value = data.value<std::string>();
+                const uint32_t length = static_cast<uint32_t>(value.size());
+                key.append(reinterpret_cast<const char*>(&length), sizeof(length));
+                key.append(value);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    static bool is_supported(
+            xtypes::TypeKind kind)
+    {
+        switch (kind)
+        {
+            case xtypes::TypeKind::BOOLEAN_TYPE:
+            case xtypes::TypeKind::CHAR_8_TYPE:
+            case xtypes::TypeKind::UINT_8_TYPE:
+            case xtypes::TypeKind::INT_16_TYPE:
+            case xtypes::TypeKind::UINT_16_TYPE:
+            case xtypes::TypeKind::INT_32_TYPE:
+            case xtypes::TypeKind::UINT_32_TYPE:
+            case xtypes::TypeKind::INT_64_TYPE:
+            case xtypes::TypeKind::UINT_64_TYPE:
+            case xtypes::TypeKind::FLOAT_32_TYPE:
+            case xtypes::TypeKind::FLOAT_64_TYPE:
+            case xtypes::TypeKind::STRING_TYPE:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    bool compile_field(
+            const std::string& field_name,
+            const xtypes::DynamicType& message_type)
+    {
+        Field field;
+        const xtypes::DynamicType* type = &message_type;
+
+        std::size_t begin = 0;
+        while (begin <= field_name.size())
+        {
+            std::size_t end = field_name.find('.', begin);
+            if (std::string::npos == end)
+            {
+                end = field_name.size();
+            }
+
+            if (xtypes::TypeKind::STRUCTURE_TYPE != type->kind())
+            {
+                return false;
+            }
+
+            const std::string member_name = field_name.substr(begin, end - begin);
+            const auto& members = static_cast<const xtypes::StructType*>(type)->members();
+
+            std::size_t index = 0;
+            while (index < members.size() && members[index].name() != member_name)
+            {
+                ++index;
+            }
+
+            if (index == members.size())
+            {
+                return false;
+            }
+
+            field.path.push_back(index);
+            type = &members[index].type();
+            begin = end + 1;
+        }
+
+        if (!is_supported(type->kind()))
+        {
+            return false;
+        }
+
+        field.kind = type->kind();
+        _fields.emplace_back(std::move(field));
+        return true;
+    }
+
+    bool compile(
+            const std::string& topic_template,
+            const xtypes::DynamicType& message_type)
+    {
+        static const std::string message_prefix = "message.";
+
+        std::size_t open = topic_template.find('{');
+        while (std::string::npos != open)
+        {
+            const std::size_t close = topic_template.find('}', open);
+            if (std::string::npos == close)
+            {
+                return false;
+            }
+
+            const std::string substitution = topic_template.substr(open + 1, close - open - 1);
+            if (0 != substitution.compare(0, message_prefix.size(), message_prefix)
+                    || !compile_field(substitution.substr(message_prefix.size()), message_type))
+            {
+                _fields.clear();
+                return false;
+            }
+
+            open = topic_template.find('{', close);
+        }
+
+        return !_fields.empty();
+    }
+
+    std::vector<Field> _fields;
+    const bool _compiled;
+
+};
+
+} // anonymous namespace
+
 //==============================================================================
 class MetaPublisher : public is::TopicPublisher
 {
@@ -36,50 +259,178 @@ public:
 
     MetaPublisher(
             core::StringTemplate&& topic_template,
+            const std::string& topic_template_string,
             const eprosima::xtypes::DynamicType& message_type,
             ros::NodeHandle& node,
             uint32_t queue_size,
             bool latch,
-            const YAML::Node& /*unused*/)
+            const TopicOptions& options,
+            const YAML::Node& configuration)
         : _topic_template(std::move(topic_template))
-        , _message_type(message_type)
+        , _key(topic_template_string, message_type)
+        , _message_type_id(Factory::instance().type_id(message_type.name()))
         , _node(node)
         , _queue_size(queue_size)
         , _latch(latch)
+        , _options(options)
+        , _max_publishers(configuration["max_publishers"].as<std::size_t>(1024))
+        , _idle_timeout(configuration["publisher_idle_timeout_ms"].as<uint32_t>(0))
+        , _last(_publishers.end())
+        , _logger("is::sh::ROS1::MetaPublisher")
+    {
+        if (!_key.compiled())
+        {
+            _logger << utils::Logger::Level::DEBUG
+                    << "The topic template '" << topic_template_string
+                    << "' will be computed for every message" << std::endl;
+        }
+
+        // The idle publishers are also evicted while no message arrives at all.
+        if (_idle_timeout.count() > 0)
+        {
+            _idle_timer = node.createWallTimer(
+                ros::WallDuration(_idle_timeout.count() / 1000.0),
+                &MetaPublisher::on_idle_timer, this);
+        }
+    }
+
+    ~MetaPublisher() override
     {
-        // Do nothing
+        _idle_timer.stop();
     }
 
     bool publish(
             const eprosima::xtypes::DynamicData& message) override final
     {
-        const std::string topic_name = _topic_template.compute_string(message);
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        if (_key.compiled())
+        {
+            _key.compute(message, _current_key);
+        }
+        else
+        {
+            _current_key = _topic_template.compute_string(message);
+        }
 
-        const auto insertion = _publishers.insert(
-            std::make_pair(std::move(topic_name), nullptr));
-        const bool inserted = insertion.second;
-        TopicPublisherPtr& publisher = insertion.first->second;
+        const Clock::time_point now = Clock::now();
 
-        if (inserted)
+        // Consecutive messages usually go to the same topic, which needs neither the
+        // topic name nor a lookup.
+        if (_last == _publishers.end() || _last->key != _current_key)
         {
-            publisher = Factory::instance().create_publisher(
-                _message_type, _node, topic_name, _queue_size, _latch);
+            const auto it = _index.find(_current_key);
+            if (it != _index.end())
+            {
+                _last = it->second;
+            }
+            else
+            {
+                const std::string topic_name = _key.compiled()
+                        ? _topic_template.compute_string(message)
+                        : _current_key;
+
+                TopicPublisherPtr publisher = Factory::instance().create_publisher(
+                    _message_type_id, _node, topic_name, _queue_size, _latch, _options);
+
+                if (!publisher)
+                {
+                    return false;
+                }
+
+                if (0 < _max_publishers && _publishers.size() >= _max_publishers)
+                {
+                    evict(std::prev(_publishers.end()), "the maximum number of publishers was reached");
+                }
+
+                _publishers.push_front(Entry{_current_key, topic_name, std::move(publisher), now});
+                _index.emplace(_current_key, _publishers.begin());
+                _last = _publishers.begin();
+            }
         }
 
+        _last->last_used = now;
+        _publishers.splice(_publishers.begin(), _publishers, _last);
+
+        evict_idle(now, 1);
+
+        const TopicPublisherPtr publisher = _last->publisher;
+        lock.unlock();
+
         return publisher->publish(message);
     }
 
 private:
 
+    using Clock = std::chrono::steady_clock;
+    using TopicPublisherPtr = std::shared_ptr<TopicPublisher>;
+
+    struct Entry
+    {
+        std::string key;
+        std::string topic_name;
+        TopicPublisherPtr publisher;
+        Clock::time_point last_used;
+    };
+
+    using PublisherList = std::list<Entry>;
+
+    /**
+     * Must be called with the mutex held.
+     */
+    void evict_idle(
+            Clock::time_point now,
+            std::size_t keep)
+    {
+        // The publishers are sorted by their last use, so the idle ones are at the back.
+        while (_idle_timeout.count() > 0 && _publishers.size() > keep
+                && now - _publishers.back().last_used > _idle_timeout)
+        {
+            evict(std::prev(_publishers.end()), "it was idle for too long");
+        }
+    }
+
+    void on_idle_timer(
+            const ros::WallTimerEvent& /*event*/)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        evict_idle(Clock::now(), 0);
+    }
+
+    void evict(
+            PublisherList::iterator entry,
+            const char* reason)
+    {
+        _logger << utils::Logger::Level::DEBUG
+                << "Unadvertising topic '" << entry->topic_name << "', since "
+                << reason << std::endl;
+
+        if (entry == _last)
+        {
+            _last = _publishers.end();
+        }
+
+        _index.erase(entry->key);
+        _publishers.erase(entry);
+    }
+
     const core::StringTemplate _topic_template;
-    const eprosima::xtypes::DynamicType& _message_type;
+    const TopicTemplateKey _key;
+    const Factory::TypeId _message_type_id;
     ros::NodeHandle& _node;
     const uint32_t _queue_size;
     const bool _latch;
+    const TopicOptions _options;
+    const std::size_t _max_publishers;
+    const std::chrono::milliseconds _idle_timeout;
 
-    using TopicPublisherPtr = std::shared_ptr<TopicPublisher>;
-    using PublisherMap = std::unordered_map<std::string, TopicPublisherPtr>;
-    PublisherMap _publishers;
+    std::mutex _mutex;
+    std::string _current_key;
+    PublisherList _publishers;
+    std::unordered_map<std::string, PublisherList::iterator> _index;
+    PublisherList::iterator _last;
+    utils::Logger _logger;
+    ros::WallTimer _idle_timer;
 
 };
 
@@ -103,11 +454,12 @@ std::shared_ptr<is::TopicPublisher> make_meta_publisher(
         const std::string& topic_name,
         uint32_t queue_size,
         bool latch,
+        const TopicOptions& options,
         const YAML::Node& configuration)
 {
     return std::make_shared<MetaPublisher>(
         core::StringTemplate(topic_name, make_detail_string(topic_name, message_type.name())),
-        message_type, node, queue_size, latch, configuration);
+        topic_name, message_type, node, queue_size, latch, options, configuration);
 }
 
 } //  namespace ros1
@@ -21,6 +21,8 @@
 
 #include <is/systemhandle/SystemHandle.hpp>
 
+#include <is/sh/ros1/TopicOptions.hpp>
+
 #include <ros/node_handle.h>
 
 namespace eprosima {
@@ -46,6 +48,9 @@ namespace ros1 {
  * @param[in] latch Enable/disable latching. When a connection is latched,
  *            the last message published is saved and sent to any future subscribers that connect.
  *
+ * @param[in] options The bridge-side options of the topic, shared by all the ROS 1 publishers
+ *            created for its expansions.
+ *
  * @param[in] configuration The configuration specific for this SystemHandle,
  *            as described in the user-provided *YAML* input file.
  *
@@ -57,6 +62,7 @@ std::shared_ptr<TopicPublisher> make_meta_publisher(
         const std::string& topic_name,
         uint32_t queue_size,
         bool latch,
+        const TopicOptions& options,
         const YAML::Node& configuration);
 
 } //  namespace ros1
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2020 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <is/sh/ros1/Metrics.hpp>
+
+#include <algorithm>
+#include <fstream>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif // ifdef __linux__
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace ros1 {
+
+//==============================================================================
+Metrics& Metrics::instance()
+{
+    static Metrics metrics;
+    return metrics;
+}
+
+//==============================================================================
+std::shared_ptr<EntityMetrics> Metrics::create(
+        const std::string& kind,
+        const std::string& name)
+{
+    // Not make_shared, whose single allocation would outlive the entity as long as
+    // the registry holds a weak pointer to it.
+    std::shared_ptr<EntityMetrics> metrics(new EntityMetrics(kind, name));
+
+    // Nothing takes snapshots unless the metrics are enabled, which is configured
+    // before any entity is created.
+    if (!metrics_enabled().load(std::memory_order_relaxed))
+    {
+        return metrics;
+    }
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_entities.size() >= _prune_threshold)
+    {
+        prune();
+        _prune_threshold = std::max<std::size_t>(64, 2 * _entities.size());
+    }
+
+    _entities.emplace_back(metrics);
+    return metrics;
+}
+
+//==============================================================================
+void Metrics::prune()
+{
+    _entities.erase(
+        std::remove_if(_entities.begin(), _entities.end(),
+        [](const std::weak_ptr<EntityMetrics>& entity)
+        {
+            return entity.expired();
+        }),
+        _entities.end());
+}
+
+//==============================================================================
+std::vector<MetricsSnapshot> Metrics::snapshot()
+{
+    std::vector<MetricsSnapshot> snapshots;
+    const auto now = std::chrono::steady_clock::now();
+
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    // Forget the entities that no longer exist.
+    prune();
+
+    snapshots.reserve(_entities.size());
+    for (const std::weak_ptr<EntityMetrics>& weak_entity : _entities)
+    {
+        const std::shared_ptr<EntityMetrics> entity = weak_entity.lock();
+        if (!entity)
+        {
+            continue;
+        }
+
+        snapshots.push_back(MetricsSnapshot{
+                        entity->kind,
+                        entity->name,
+                        entity->messages.load(std::memory_order_relaxed),
+                        entity->bytes.load(std::memory_order_relaxed),
+                        entity->dropped.load(std::memory_order_relaxed),
+                        entity->errors.load(std::memory_order_relaxed),
+                        entity->in_flight.load(std::memory_order_relaxed),
+                        entity->memory.load(std::memory_order_relaxed),
+                        entity->duration.load(),
+                        now
+                    });
+    }
+
+    return snapshots;
+}
+
+//==============================================================================
+uint64_t Metrics::resident_memory()
+{
+#ifdef __linux__
+    // The second field of statm is the resident set size, in pages.
+    std::ifstream statm("/proc/self/statm");
+    uint64_t size = 0;
+    uint64_t resident = 0;
+    if (statm >> size >> resident)
+    {
+        return resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    }
+#endif // ifdef __linux__
+
+    return 0;
+}
+
+} //  namespace ros1
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
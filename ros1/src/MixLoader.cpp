@@ -0,0 +1,242 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ * Copyright (C) 2020 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "MixLoader.hpp"
+
+#include <is/core/runtime/MiddlewareInterfaceExtension.hpp>
+#include <is/core/runtime/Search.hpp>
+
+#include <yaml-cpp/yaml.h>
+
+#include <chrono>
+#include <fstream>
+#include <unordered_map>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace ros1 {
+
+namespace {
+
+//==============================================================================
+double elapsed_ms(
+        const std::chrono::steady_clock::time_point& since)
+{
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - since).count();
+}
+
+} // anonymous namespace
+
+//==============================================================================
+MixLoader::MixLoader(
+        const std::string& cache_file)
+    : _cache_file(cache_file)
+    , _logger("is::sh::ROS1::MixLoader")
+{
+}
+
+//==============================================================================
+void MixLoader::add_message(
+        const std::string& type)
+{
+    _lookups[cache_key("message", type)];
+}
+
+//==============================================================================
+void MixLoader::add_service(
+        const std::string& library_name)
+{
+    _lookups[cache_key("service", library_name)];
+}
+
+//==============================================================================
+const MixLoader::Lookup& MixLoader::message(
+        const std::string& type) const
+{
+    return _lookups.at(cache_key("message", type));
+}
+
+//==============================================================================
+const MixLoader::Lookup& MixLoader::service(
+        const std::string& library_name) const
+{
+    return _lookups.at(cache_key("service", library_name));
+}
+
+//==============================================================================
+std::string MixLoader::cache_key(
+        const char* kind,
+        const std::string& name)
+{
+    return std::string(kind) + ":" + name;
+}
+
+//==============================================================================
+void MixLoader::run()
+{
+    auto start = std::chrono::steady_clock::now();
+
+    if (!_cache_file.empty())
+    {
+        read_cache();
+    }
+
+    resolve();
+
+    const double resolve_ms = elapsed_ms(start);
+    start = std::chrono::steady_clock::now();
+
+    load();
+
+    const double load_ms = elapsed_ms(start);
+
+    std::size_t cached = 0;
+    for (const auto& lookup : _lookups)
+    {
+        cached += lookup.second.from_cache ? 1 : 0;
+    }
+
+    _logger << utils::Logger::Level::INFO
+            << "Resolved " << _lookups.size() << " .mix files (" << cached
+            << " from cache) in " << resolve_ms << " ms, and loaded them in "
+            << load_ms << " ms" << std::endl;
+
+    if (!_cache_file.empty() && cached < _lookups.size())
+    {
+        write_cache();
+    }
+}
+
+//==============================================================================
+void MixLoader::read_cache()
+{
+    YAML::Node cache;
+    try
+    {
+        cache = YAML::LoadFile(_cache_file);
+    }
+    catch (const YAML::Exception&)
+    {
+        _logger << utils::Logger::Level::DEBUG
+                << "Could not read the .mix path cache '" << _cache_file
+                << "', it will be created" << std::endl;
+
+        return;
+    }
+
+    for (auto& lookup : _lookups)
+    {
+        const YAML::Node path = cache[lookup.first];
+        if (!path)
+        {
+            continue;
+        }
+
+        // Only trust the entries whose file is still there.
+        const std::string cached_path = path.as<std::string>();
+        if (std::ifstream(cached_path).good())
+        {
+            lookup.second.path = cached_path;
+            lookup.second.from_cache = true;
+        }
+    }
+}
+
+//==============================================================================
+void MixLoader::write_cache() const
+{
+    YAML::Emitter emitter;
+    emitter << YAML::BeginMap;
+    for (const auto& lookup : _lookups)
+    {
+        if (!lookup.second.path.empty())
+        {
+            emitter << YAML::Key << lookup.first << YAML::Value << lookup.second.path;
+        }
+    }
+    emitter << YAML::EndMap;
+
+    std::ofstream file(_cache_file);
+    file << emitter.c_str() << std::endl;
+
+    if (!file)
+    {
+        _logger << utils::Logger::Level::WARN
+                << "Failed to write the .mix path cache '" << _cache_file << "'" << std::endl;
+    }
+}
+
+//==============================================================================
+void MixLoader::resolve()
+{
+    // core::Search gives no guarantee of being safe to use from several threads, so the
+    // lookups are done one after the other. The cache is what spares the filesystem search.
+    core::Search search("ros1");
+    for (auto& lookup : _lookups)
+    {
+        if (!lookup.second.path.empty())
+        {
+            continue;
+        }
+
+        const std::string& key = lookup.first;
+        const std::size_t separator = key.find(':');
+        const std::string name = key.substr(separator + 1);
+
+        lookup.second.path = (0 == key.compare(0, separator, "message"))
+                ? search.find_message_mix(name, &lookup.second.checked_paths)
+                : search.find_service_mix(name, &lookup.second.checked_paths);
+    }
+}
+
+//==============================================================================
+void MixLoader::load()
+{
+    // Loading a .mix file opens its libraries, whose static registrars fill the
+    // Factory, so the loads are done one after the other. Several types usually
+    // share the same .mix file, which is loaded only once.
+    std::unordered_map<std::string, bool> loaded;
+
+    for (auto& lookup : _lookups)
+    {
+        const std::string& path = lookup.second.path;
+        if (path.empty())
+        {
+            continue;
+        }
+
+        auto it = loaded.find(path);
+        if (it == loaded.end())
+        {
+            it = loaded.emplace(path, core::Mix::from_file(path).load()).first;
+        }
+
+        lookup.second.loaded = it->second;
+    }
+
+    _logger << utils::Logger::Level::DEBUG
+            << "Loaded " << loaded.size() << " distinct .mix files for "
+            << _lookups.size() << " lookups" << std::endl;
+}
+
+} //  namespace ros1
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
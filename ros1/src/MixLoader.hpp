@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ * Copyright (C) 2020 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _IS_SH_ROS1__INTERNAL__MIXLOADER_HPP_
+#define _IS_SH_ROS1__INTERNAL__MIXLOADER_HPP_
+
+#include <is/utils/Log.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace ros1 {
+
+/**
+ * @class MixLoader
+ * @brief Finds and loads the .mix files of the types required by the SystemHandle.
+ *
+ * @details Each message type and service package is looked up only once, and each distinct
+ *          .mix file is loaded only once, no matter how many types it provides. Optionally,
+ *          the resolved paths are persisted in a cache file, so that subsequent runs can skip
+ *          the filesystem search.
+ */
+class MixLoader
+{
+public:
+
+    /**
+     * @brief The result of looking up the .mix file of a message type or a service package.
+     */
+    struct Lookup
+    {
+        std::string path;
+        std::vector<std::string> checked_paths;
+        bool from_cache = false;
+        bool loaded = false;
+    };
+
+    /**
+     * @brief Construct a new MixLoader object.
+     *
+     * @param[in] cache_file The path of the file where the resolved .mix paths are persisted.
+     *            If empty, the paths are not persisted.
+     */
+    MixLoader(
+            const std::string& cache_file);
+
+    /**
+     * @brief Request the .mix file of a message type.
+     */
+    void add_message(
+            const std::string& type);
+
+    /**
+     * @brief Request the .mix file of a service package.
+     */
+    void add_service(
+            const std::string& library_name);
+
+    /**
+     * @brief Find and load all the requested .mix files.
+     *
+     * @details The time spent in each phase is reported in the log.
+     */
+    void run();
+
+    /**
+     * @returns The lookup of a message type, previously requested with add_message().
+     */
+    const Lookup& message(
+            const std::string& type) const;
+
+    /**
+     * @returns The lookup of a service package, previously requested with add_service().
+     */
+    const Lookup& service(
+            const std::string& library_name) const;
+
+private:
+
+    void read_cache();
+
+    void write_cache() const;
+
+    void resolve();
+
+    void load();
+
+    static std::string cache_key(
+            const char* kind,
+            const std::string& name);
+
+    const std::string _cache_file;
+
+    /**
+     * Lookups indexed by cache_key(), sorted so that the persisted cache is stable
+     * from one run to the next.
+     */
+    std::map<std::string, Lookup> _lookups;
+
+    utils::Logger _logger;
+};
+
+} //  namespace ros1
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
+
+#endif //  _IS_SH_ROS1__INTERNAL__MIXLOADER_HPP_
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2020 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <is/sh/ros1/OverflowQueue.hpp>
+#include <is/sh/ros1/Metrics.hpp>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace ros1 {
+
+//==============================================================================
+OverflowQueue::OverflowQueue(
+        const OverflowOptions& options,
+        Handler handler,
+        std::shared_ptr<EntityMetrics> metrics)
+    : _options(options)
+    , _handler(std::move(handler))
+    , _metrics(std::move(metrics))
+    , _thread([this]()
+        {
+            drain();
+        })
+{
+}
+
+//==============================================================================
+OverflowQueue::~OverflowQueue()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+
+    _not_empty.notify_all();
+    _not_full.notify_all();
+    _thread.join();
+}
+
+//==============================================================================
+bool OverflowQueue::push(
+        const MsgConstPtr& msg)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    if (_queue.size() >= _options.capacity)
+    {
+        switch (_options.policy)
+        {
+            case OverflowOptions::Policy::DROP_OLDEST:
+                _queue.pop_front();
+                _metrics->dropped.fetch_add(1, std::memory_order_relaxed);
+                break;
+            case OverflowOptions::Policy::DROP_NEWEST:
+                _metrics->dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            case OverflowOptions::Policy::BLOCK:
+                _not_full.wait(lock, [this]()
+                    {
+                        return _stop || _queue.size() < _options.capacity;
+                    });
+
+                if (_stop)
+                {
+                    return false;
+                }
+                break;
+        }
+    }
+
+    _queue.push_back(msg);
+    _metrics->in_flight.store(static_cast<int64_t>(_queue.size()), std::memory_order_relaxed);
+
+    lock.unlock();
+    _not_empty.notify_one();
+    return true;
+}
+
+//==============================================================================
+void OverflowQueue::drain()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true)
+    {
+        _not_empty.wait(lock, [this]()
+            {
+                return _stop || !_queue.empty();
+            });
+
+        // The messages still queued when stopping are handed over before leaving.
+        if (_queue.empty())
+        {
+            return;
+        }
+
+        const MsgConstPtr msg = std::move(_queue.front());
+        _queue.pop_front();
+        _metrics->in_flight.store(static_cast<int64_t>(_queue.size()), std::memory_order_relaxed);
+
+        lock.unlock();
+        _not_full.notify_one();
+        _handler(msg);
+        lock.lock();
+    }
+}
+
+} //  namespace ros1
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2020 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "Passthrough.hpp"
+
+#include <is/sh/ros1/Factory.hpp>
+#include <is/sh/ros1/Log.hpp>
+#include <is/sh/ros1/LoopbackFilter.hpp>
+#include <is/sh/ros1/utilities.hpp>
+
+#include <topic_tools/shape_shifter.h>
+
+#include <mutex>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace ros1 {
+namespace passthrough {
+
+static utils::Logger logger("is::sh::ROS1::Passthrough");
+
+// Member indices of the serialized message type.
+constexpr std::size_t datatype_index = 0;
+constexpr std::size_t md5sum_index = 1;
+constexpr std::size_t message_definition_index = 2;
+constexpr std::size_t data_index = 3;
+
+//==============================================================================
+const xtypes::StructType type()
+{
+    xtypes::StructType type(g_msg_name);
+    type.add_member("datatype", xtypes::StringType());
+    type.add_member("md5sum", xtypes::StringType());
+    type.add_member("message_definition", xtypes::StringType());
+    type.add_member("data", xtypes::SequenceType(xtypes::primitive_type<uint8_t>()));
+    return type;
+}
+
+namespace {
+TypeToFactoryRegistrar register_type(g_msg_name, &type);
+} //  anonymous namespace
+
+//==============================================================================
+class Subscription final
+{
+public:
+
+    Subscription(
+            ros::NodeHandle& node,
+            const std::string& topic_name,
+            const xtypes::DynamicType& message_type,
+            TopicSubscriberSystem::SubscriptionCallback* callback,
+            uint32_t queue_size,
+            const ros::TransportHints& transport_hints)
+        : _topic(topic_name)
+        , _callback(callback)
+        , _data(message_type)
+    {
+        ros::SubscribeOptions options = make_loopback_filtering_options<topic_tools::ShapeShifter>(
+            topic_name, queue_size,
+            [this](const ros::MessageEvent<topic_tools::ShapeShifter const>& msg_event)
+            {
+                subscription_callback(msg_event);
+            },
+            _loopback_filter, transport_hints);
+
+        _subscription = node.subscribe(options);
+    }
+
+private:
+
+    void subscription_callback(
+            const ros::MessageEvent<topic_tools::ShapeShifter const>& msg_event)
+    {
+        IS_ROS1_HOT_PATH_LOG(logger, utils::Logger::Level::INFO,
+                "Receiving serialized message from ROS 1 for topic '" << _topic << "'");
+
+        // Local publications received through a connection are discarded before being
+        // deserialized, but intraprocess ones are handed over without that step.
+        if (_loopback_filter->is_local(msg_event.getConnectionHeaderPtr()))
+        {
+            // This is a local publication from within Integration Service. Return
+            return;
+        }
+
+        const topic_tools::ShapeShifter& message = *msg_event.getMessage();
+
+        _data[datatype_index] = message.getDataType();
+        _data[md5sum_index] = message.getMD5Sum();
+        _data[message_definition_index] = message.getMessageDefinition();
+
+        // Write the serialized message straight into the DynamicData bytes.
+        const uint32_t size = message.size();
+        uint8_t* bytes = convert__primitive_sequence::resize<uint8_t>(_data[data_index], size);
+        ros::serialization::OStream stream(bytes, size);
+        message.write(stream);
+
+        (*_callback)(_data, nullptr);
+    }
+
+    const std::string _topic;
+
+    TopicSubscriberSystem::SubscriptionCallback* _callback;
+
+    const std::shared_ptr<LoopbackFilter> _loopback_filter = std::make_shared<LoopbackFilter>();
+
+    xtypes::DynamicData _data;
+
+    ros::Subscriber _subscription;
+};
+
+//==============================================================================
+std::shared_ptr<void> subscribe(
+        ros::NodeHandle& node,
+        const std::string& topic_name,
+        const xtypes::DynamicType& message_type,
+        TopicSubscriberSystem::SubscriptionCallback* callback,
+        const uint32_t queue_size,
+        const ros::TransportHints& transport_hints,
+        const TopicOptions& /*options*/)
+{
+    return std::make_shared<Subscription>(
+        node, topic_name, message_type, callback, queue_size, transport_hints);
+}
+
+namespace {
+SubscriptionToFactoryRegistrar register_subscriber(g_msg_name, &subscribe);
+} //  anonymous namespace
+
+//==============================================================================
+class Publisher final : public virtual is::TopicPublisher
+{
+public:
+
+    Publisher(
+            ros::NodeHandle& node,
+            const std::string& topic_name,
+            uint32_t queue_size,
+            bool latch)
+        : _node(node)
+        , _topic_name(topic_name)
+        , _queue_size(queue_size)
+        , _latch(latch)
+    {
+        // The publisher cannot be advertised until the first message
+        // tells which ROS 1 type it carries.
+    }
+
+    bool publish(
+            const xtypes::DynamicData& message) override
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        const std::string& md5sum = message[md5sum_index].value<std::string>();
+
+        if (!_publisher)
+        {
+            _shape_shifter.morph(
+                md5sum,
+                message[datatype_index].value<std::string>(),
+                message[message_definition_index].value<std::string>(),
+                _latch ? "true" : "false");
+
+            _publisher = _shape_shifter.advertise(_node, _topic_name, _queue_size, _latch);
+        }
+        else if (md5sum != _shape_shifter.getMD5Sum())
+        {
+            logger << utils::Logger::Level::ERROR
+                   << "Dropping serialized message for topic '" << _topic_name
+                   << "': its type '" << message[datatype_index].value<std::string>()
+                   << "' does not match the advertised type '"
+                   << _shape_shifter.getDataType() << "'" << std::endl;
+
+            return false;
+        }
+
+        const xtypes::ReadableDynamicDataRef data = message[data_index];
+        const uint32_t size = static_cast<uint32_t>(data.size());
+        ros::serialization::IStream stream(
+            0 < size ? const_cast<uint8_t*>(&data[0].value<uint8_t>()) : nullptr, size);
+        _shape_shifter.read(stream);
+
+        IS_ROS1_HOT_PATH_LOG(logger, utils::Logger::Level::INFO,
+                "Sending serialized message from Integration Service to ROS 1 for topic '"
+                << _topic_name << "' (" << size << " bytes)");
+
+        _publisher.publish(_shape_shifter);
+        return true;
+    }
+
+private:
+
+    ros::NodeHandle& _node;
+    const std::string _topic_name;
+    const uint32_t _queue_size;
+    const bool _latch;
+
+    std::mutex _mutex;
+    topic_tools::ShapeShifter _shape_shifter;
+    ros::Publisher _publisher;
+};
+
+//==============================================================================
+std::shared_ptr<is::TopicPublisher> make_publisher(
+        ros::NodeHandle& node,
+        const std::string& topic_name,
+        const uint32_t queue_size,
+        const bool latch,
+        const TopicOptions& /*options*/)
+{
+    return std::make_shared<Publisher>(node, topic_name, queue_size, latch);
+}
+
+namespace {
+PublisherToFactoryRegistrar register_publisher(g_msg_name, &make_publisher);
+} //  anonymous namespace
+
+} //  namespace passthrough
+} //  namespace ros1
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
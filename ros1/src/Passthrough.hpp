@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2020 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _IS_SH_ROS1__INTERNAL__PASSTHROUGH_HPP_
+#define _IS_SH_ROS1__INTERNAL__PASSTHROUGH_HPP_
+
+#include <string>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace ros1 {
+namespace passthrough {
+
+/**
+ * @brief Name of the built-in type that carries an already serialized ROS 1 message.
+ *
+ * @details Topics declared with this type are bridged by means of a
+ *          `topic_tools::ShapeShifter`, so that the ROS 1 messages are never
+ *          deserialized nor converted member by member. The type is a structure with
+ *          the ROS 1 `datatype`, `md5sum` and `message_definition` of the carried message,
+ *          along with its serialized `data`, as a sequence of bytes.
+ *
+ *          The type, along with its subscription and publisher factories,
+ *          is registered in the Factory by the ROS 1 SystemHandle library itself,
+ *          so that no *mix* file is needed for it.
+ */
+const std::string g_msg_name = "ros1/SerializedMessage";
+
+} //  namespace passthrough
+} //  namespace ros1
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
+
+#endif //  _IS_SH_ROS1__INTERNAL__PASSTHROUGH_HPP_
@@ -0,0 +1,539 @@
+/*
+ * Copyright (C) 2020 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <is/sh/ros1/SharedMemory.hpp>
+
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+
+#include <sys/file.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace ros1 {
+
+namespace bip = boost::interprocess;
+
+namespace {
+
+constexpr uint32_t segment_magic = 0x49535231; // "ISR1"
+constexpr uint32_t retired_magic = 0x49535230; // "ISR0"
+constexpr uint32_t segment_version = 2;
+constexpr std::size_t cache_line = 64;
+
+// How long to wait for the writer that created a segment to lay it out,
+// and for the segments left behind by crashed writers to be replaced.
+constexpr std::chrono::milliseconds attach_timeout(1000);
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+        "The shared memory ring needs address-free 64 bit atomics");
+
+//==============================================================================
+struct SegmentHeader
+{
+    std::atomic<uint32_t> magic;
+    uint32_t version;
+    uint32_t slots;
+    uint32_t slot_size;
+    uint64_t slot_stride;
+
+    // Handles start from the creation time of the segment, so that the handles of a segment
+    // that replaces another one with the same name are always greater than the old ones.
+    uint64_t first_handle;
+    std::atomic<uint64_t> next_handle;
+
+    char datatype[256];
+    char md5sum[64];
+};
+
+//==============================================================================
+struct SlotHeader
+{
+    // 2 * handle + 1 while the message of the handle is being written, 2 * handle + 2 once written.
+    std::atomic<uint64_t> state;
+    std::atomic<uint32_t> size;
+};
+
+//==============================================================================
+constexpr std::size_t align(
+        std::size_t size)
+{
+    return (size + cache_line - 1) / cache_line * cache_line;
+}
+
+constexpr std::size_t header_size = align(sizeof(SegmentHeader));
+constexpr std::size_t slot_header_size = align(sizeof(SlotHeader));
+
+//==============================================================================
+void copy_string(
+        char* destination,
+        std::size_t capacity,
+        const std::string& source)
+{
+    const std::size_t length = std::min(source.size(), capacity - 1);
+    std::memcpy(destination, source.data(), length);
+    destination[length] = '\0';
+}
+
+} //  anonymous namespace
+
+//==============================================================================
+class SharedMemoryRing::Implementation
+{
+public:
+
+    Implementation(
+            const std::string& segment,
+            bip::shared_memory_object&& shm,
+            bool writer)
+        : _segment(segment)
+        , _shm(std::move(shm))
+        , _writer(writer)
+    {
+    }
+
+    ~Implementation()
+    {
+        // The last writer is the only one that can turn its shared lock into an exclusive one.
+        if (_writer && nullptr != header() && lock(LOCK_EX | LOCK_NB))
+        {
+            retire();
+        }
+    }
+
+    /**
+     * Every live writer holds a shared lock on the segment, which the system releases
+     * when the writer goes away, even if it crashes.
+     */
+    bool lock(
+            int operation)
+    {
+        return 0 == ::flock(_shm.get_mapping_handle().handle, operation);
+    }
+
+    void unlock()
+    {
+        ::flock(_shm.get_mapping_handle().handle, LOCK_UN);
+    }
+
+    /**
+     * Mark the segment as replaced, for the writers that opened it meanwhile, and remove it.
+     */
+    void retire()
+    {
+        if (nullptr != header())
+        {
+            header()->magic.store(retired_magic, std::memory_order_release);
+        }
+
+        bip::shared_memory_object::remove(_segment.c_str());
+    }
+
+    uint32_t magic()
+    {
+        bip::offset_t size = 0;
+        _shm.get_size(size);
+        if (static_cast<std::size_t>(size) < header_size)
+        {
+            return 0;
+        }
+
+        if (!_region.get_address())
+        {
+            _region = bip::mapped_region(_shm, bip::read_write);
+        }
+
+        return header()->magic.load(std::memory_order_acquire);
+    }
+
+    bool map(
+            std::string& error)
+    {
+        bool retired = false;
+        return map(error, retired);
+    }
+
+    bool map(
+            std::string& error,
+            bool& retired)
+    {
+        // The writer that creates the segment may still be laying it out.
+        const auto deadline = std::chrono::steady_clock::now() + attach_timeout;
+        while (true)
+        {
+            const uint32_t current = magic();
+            if (segment_magic == current)
+            {
+                break;
+            }
+
+            if (retired_magic == current)
+            {
+                retired = true;
+                error = "the shared memory segment '" + _segment + "' was replaced";
+                return false;
+            }
+
+            if (std::chrono::steady_clock::now() > deadline)
+            {
+                error = "the shared memory segment '" + _segment + "' was never initialized";
+                return false;
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        const SegmentHeader* h = header();
+        if (segment_version != h->version
+                || _region.get_size() < header_size + h->slots * h->slot_stride)
+        {
+            error = "the shared memory segment '" + _segment + "' has an unexpected layout";
+            return false;
+        }
+
+        return true;
+    }
+
+    void initialize(
+            const SharedMemoryOptions& options,
+            const std::string& datatype,
+            const std::string& md5sum)
+    {
+        const uint64_t slot_stride = align(slot_header_size + options.slot_size);
+        _shm.truncate(static_cast<bip::offset_t>(header_size + options.slots * slot_stride));
+        _region = bip::mapped_region(_shm, bip::read_write);
+
+        SegmentHeader* h = new (_region.get_address()) SegmentHeader();
+        h->version = segment_version;
+        h->slots = options.slots;
+        h->slot_size = options.slot_size;
+        h->slot_stride = slot_stride;
+        h->first_handle = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+        h->next_handle.store(h->first_handle, std::memory_order_relaxed);
+        copy_string(h->datatype, sizeof(h->datatype), datatype);
+        copy_string(h->md5sum, sizeof(h->md5sum), md5sum);
+
+        for (uint32_t i = 0; i < options.slots; ++i)
+        {
+            SlotHeader* slot = new (slot_address(i)) SlotHeader();
+            slot->state.store(0, std::memory_order_relaxed);
+            slot->size.store(0, std::memory_order_relaxed);
+        }
+
+        // Publish the layout to the processes waiting in map().
+        h->magic.store(segment_magic, std::memory_order_release);
+    }
+
+    SegmentHeader* header() const
+    {
+        return static_cast<SegmentHeader*>(_region.get_address());
+    }
+
+    uint8_t* slot_address(
+            uint64_t index) const
+    {
+        return static_cast<uint8_t*>(_region.get_address())
+               + header_size + index * header()->slot_stride;
+    }
+
+    SlotHeader* slot(
+            uint64_t handle) const
+    {
+        return reinterpret_cast<SlotHeader*>(slot_address(handle % header()->slots));
+    }
+
+    uint8_t* slot_data(
+            uint64_t handle) const
+    {
+        return slot_address(handle % header()->slots) + slot_header_size;
+    }
+
+    const std::string _segment;
+    bip::shared_memory_object _shm;
+    bip::mapped_region _region;
+    bool _writer;
+};
+
+//==============================================================================
+std::unique_ptr<SharedMemoryRing> SharedMemoryRing::create(
+        const SharedMemoryOptions& options,
+        const std::string& datatype,
+        const std::string& md5sum,
+        std::string& error)
+{
+    const auto start = std::chrono::steady_clock::now();
+    const auto deadline = start + attach_timeout;
+
+    try
+    {
+        while (std::chrono::steady_clock::now() < deadline)
+        {
+            try
+            {
+                bip::shared_memory_object shm(bip::create_only, options.segment.c_str(), bip::read_write);
+                auto pimpl = std::make_unique<Implementation>(options.segment, std::move(shm), true);
+
+                // Take the writer lock before laying the segment out, so that no other writer
+                // mistakes it for the segment of a crashed one.
+                pimpl->lock(LOCK_SH);
+                pimpl->initialize(options, datatype, md5sum);
+                return std::unique_ptr<SharedMemoryRing>(new SharedMemoryRing(std::move(pimpl)));
+            }
+            catch (const bip::interprocess_exception& e)
+            {
+                if (bip::already_exists_error != e.get_error_code())
+                {
+                    throw;
+                }
+            }
+
+            bip::shared_memory_object shm(bip::open_only, options.segment.c_str(), bip::read_write);
+            auto pimpl = std::make_unique<Implementation>(options.segment, std::move(shm), false);
+
+            // Nobody holding the writer lock means that every writer of the segment is gone,
+            // possibly without cleaning up, so it is replaced by a new one.
+            if (pimpl->lock(LOCK_EX | LOCK_NB))
+            {
+                if (0 == pimpl->magic() && std::chrono::steady_clock::now() < start + attach_timeout / 2)
+                {
+                    // Its creator may be about to take the writer lock.
+                    pimpl->unlock();
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    continue;
+                }
+
+                pimpl->retire();
+                continue;
+            }
+
+            pimpl->lock(LOCK_SH);
+
+            bool retired = false;
+            if (!pimpl->map(error, retired))
+            {
+                if (retired)
+                {
+                    continue;
+                }
+
+                return nullptr;
+            }
+
+            const SegmentHeader* h = pimpl->header();
+            if (md5sum != h->md5sum)
+            {
+                error = "the shared memory segment '" + options.segment + "' holds messages of type '"
+                        + h->datatype + "' instead of '" + datatype + "'";
+                return nullptr;
+            }
+
+            if (options.slots != h->slots || options.slot_size != h->slot_size)
+            {
+                error = "the shared memory segment '" + options.segment + "' has "
+                        + std::to_string(h->slots) + " slots of " + std::to_string(h->slot_size)
+                        + " bytes, instead of the configured " + std::to_string(options.slots)
+                        + " slots of " + std::to_string(options.slot_size) + " bytes";
+                return nullptr;
+            }
+
+            pimpl->_writer = true;
+            return std::unique_ptr<SharedMemoryRing>(new SharedMemoryRing(std::move(pimpl)));
+        }
+    }
+    catch (const bip::interprocess_exception& e)
+    {
+        error = "could not create the shared memory segment '" + options.segment + "': " + e.what();
+        return nullptr;
+    }
+
+    error = "the shared memory segment '" + options.segment + "' kept being replaced by other writers";
+    return nullptr;
+}
+
+//==============================================================================
+std::unique_ptr<SharedMemoryRing> SharedMemoryRing::open(
+        const std::string& segment,
+        const std::string& md5sum,
+        std::string& error)
+{
+    try
+    {
+        bip::shared_memory_object shm(bip::open_only, segment.c_str(), bip::read_write);
+        auto pimpl = std::make_unique<Implementation>(segment, std::move(shm), false);
+        if (!pimpl->map(error))
+        {
+            return nullptr;
+        }
+
+        const SegmentHeader* h = pimpl->header();
+        if (md5sum != h->md5sum)
+        {
+            error = "the shared memory segment '" + segment + "' holds messages of type '"
+                    + h->datatype + "', whose MD5 sum does not match";
+            return nullptr;
+        }
+
+        return std::unique_ptr<SharedMemoryRing>(new SharedMemoryRing(std::move(pimpl)));
+    }
+    catch (const bip::interprocess_exception& e)
+    {
+        error = "could not open the shared memory segment '" + segment + "': " + e.what();
+        return nullptr;
+    }
+}
+
+//==============================================================================
+SharedMemoryRing::SharedMemoryRing(
+        std::unique_ptr<Implementation> pimpl)
+    : _pimpl(std::move(pimpl))
+{
+}
+
+//==============================================================================
+SharedMemoryRing::~SharedMemoryRing() = default;
+
+//==============================================================================
+uint8_t* SharedMemoryRing::begin_write(
+        uint32_t size,
+        uint64_t& handle)
+{
+    SegmentHeader* h = _pimpl->header();
+    if (size > h->slot_size)
+    {
+        return nullptr;
+    }
+
+    handle = h->next_handle.fetch_add(1, std::memory_order_relaxed);
+
+    SlotHeader* slot = _pimpl->slot(handle);
+    slot->state.store(2 * handle + 1, std::memory_order_relaxed);
+    slot->size.store(size, std::memory_order_relaxed);
+
+    // Readers must see the slot as being written before any of its bytes change.
+    std::atomic_thread_fence(std::memory_order_release);
+
+    return _pimpl->slot_data(handle);
+}
+
+//==============================================================================
+void SharedMemoryRing::end_write(
+        uint64_t handle)
+{
+    _pimpl->slot(handle)->state.store(2 * handle + 2, std::memory_order_release);
+}
+
+//==============================================================================
+SharedMemoryRing::ReadResult SharedMemoryRing::copy(
+        uint64_t handle,
+        std::vector<uint8_t>& buffer) const
+{
+    const SegmentHeader* h = _pimpl->header();
+    if (handle < h->first_handle || handle >= h->next_handle.load(std::memory_order_acquire))
+    {
+        return ReadResult::INVALID;
+    }
+
+    const SlotHeader* slot = _pimpl->slot(handle);
+    const uint64_t state = slot->state.load(std::memory_order_acquire);
+    if (2 * handle + 2 != state)
+    {
+        return ReadResult::OVERWRITTEN;
+    }
+
+    const uint32_t size = slot->size.load(std::memory_order_relaxed);
+    if (size > h->slot_size)
+    {
+        return ReadResult::INVALID;
+    }
+
+    buffer.resize(size);
+    std::memcpy(buffer.data(), _pimpl->slot_data(handle), size);
+
+    // The copy must be complete before checking that the writer did not touch the slot meanwhile.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot->state.load(std::memory_order_relaxed) != state)
+    {
+        return ReadResult::OVERWRITTEN;
+    }
+
+    return ReadResult::OK;
+}
+
+//==============================================================================
+bool SharedMemoryRing::stale(
+        uint64_t handle) const
+{
+    return handle >= _pimpl->header()->next_handle.load(std::memory_order_acquire);
+}
+
+//==============================================================================
+const std::string& SharedMemoryRing::segment() const
+{
+    return _pimpl->_segment;
+}
+
+//==============================================================================
+uint32_t SharedMemoryRing::slot_size() const
+{
+    return _pimpl->header()->slot_size;
+}
+
+//==============================================================================
+SharedMemoryReader::SharedMemoryReader(
+        const std::string& segment,
+        const std::string& md5sum)
+    : _segment(segment)
+    , _md5sum(md5sum)
+{
+}
+
+//==============================================================================
+bool SharedMemoryReader::attach(
+        uint64_t handle,
+        std::string& error)
+{
+    if (!_ring || _ring->stale(handle))
+    {
+        // The writer may have replaced the segment, either by restarting or
+        // because the previous one was left behind by a crashed process.
+        _ring = SharedMemoryRing::open(_segment, _md5sum, error);
+    }
+
+    return static_cast<bool>(_ring);
+}
+
+//==============================================================================
+const std::string& SharedMemoryReader::segment() const
+{
+    return _segment;
+}
+
+} //  namespace ros1
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
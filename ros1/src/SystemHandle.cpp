@@ -18,19 +18,59 @@
 
 #include "SystemHandle.hpp"
 #include "MetaPublisher.hpp"
+#include "MixLoader.hpp"
+#include "Passthrough.hpp"
 
 #include <is/sh/ros1/Factory.hpp>
+#include <is/sh/ros1/Log.hpp>
+#include <is/sh/ros1/TopicOptions.hpp>
 
-#include <is/core/runtime/MiddlewareInterfaceExtension.hpp>
-#include <is/core/runtime/Search.hpp>
+#include <diagnostic_msgs/DiagnosticArray.h>
 
+#include <ros/callback_queue.h>
+#include <ros/init.h>
 #include <ros/this_node.h>
 
+#include <chrono>
+#include <map>
+#include <unordered_map>
+
 namespace eprosima {
 namespace is {
 namespace sh {
 namespace ros1 {
 
+namespace {
+
+//==============================================================================
+/**
+ * Read an optional scalar option. Unlike YAML::Node::as() with a fallback, which silently
+ * takes the fallback, and without it, which throws, a value of the wrong type is logged
+ * and reported, so that the configuration fails cleanly.
+ */
+template<typename T>
+bool read_option(
+        utils::Logger& logger,
+        const char* section,
+        const YAML::Node& configuration,
+        const char* key,
+        T& value)
+{
+    const YAML::Node node = configuration[key];
+    if (!node || (node.IsScalar() && YAML::convert<T>::decode(node, value)))
+    {
+        return true;
+    }
+
+    logger << utils::Logger::Level::ERROR
+           << "Invalid value for the '" << key << "' parameter of the '"
+           << section << "' section" << std::endl;
+
+    return false;
+}
+
+} //  anonymous namespace
+
 //==============================================================================
 void SystemHandle::print_missing_mix_file(
         const std::string& msg_or_srv,
@@ -56,8 +96,422 @@ void SystemHandle::print_missing_mix_file(
 
 //==============================================================================
 SystemHandle::SystemHandle()
-    : _logger("is::sh::ROS1")
+    : _spin_mode(SpinMode::EVENT)
+    , _spin_timeout(default_spin_timeout_ms / 1000.0)
+    , _spinners_started(false)
+    , _logger("is::sh::ROS1")
+{
+}
+
+//==============================================================================
+bool SystemHandle::configure_spin(
+        const YAML::Node& configuration)
+{
+    if (!configuration)
+    {
+        return true;
+    }
+
+    const std::string mode = configuration["mode"].as<std::string>("event");
+
+    if (mode == "event")
+    {
+        const uint32_t timeout_ms =
+                configuration["timeout_ms"].as<uint32_t>(default_spin_timeout_ms);
+
+        _spin_mode = SpinMode::EVENT;
+        _spin_timeout = ros::WallDuration(timeout_ms / 1000.0);
+
+        _logger << utils::Logger::Level::DEBUG
+                << "Spinning in 'event' mode, with a timeout of "
+                << timeout_ms << " ms" << std::endl;
+    }
+    else if (mode == "poll")
+    {
+        const uint32_t period_ms =
+                configuration["period_ms"].as<uint32_t>(default_spin_period_ms);
+
+        if (0 == period_ms)
+        {
+            _logger << utils::Logger::Level::ERROR
+                    << "The 'period_ms' spin parameter must be greater than zero" << std::endl;
+
+            return false;
+        }
+
+        _spin_mode = SpinMode::POLL;
+        _spin_rate = std::make_unique<ros::WallRate>(1000.0 / period_ms);
+
+        _logger << utils::Logger::Level::DEBUG
+                << "Spinning in 'poll' mode, with a period of "
+                << period_ms << " ms" << std::endl;
+    }
+    else if (mode == "async")
+    {
+        // A thread count of zero lets roscpp use one thread per hardware core.
+        const uint32_t threads = configuration["threads"].as<uint32_t>(0);
+        const uint32_t timeout_ms =
+                configuration["timeout_ms"].as<uint32_t>(default_spin_timeout_ms);
+
+        _spin_mode = SpinMode::ASYNC;
+        _spin_timeout = ros::WallDuration(timeout_ms / 1000.0);
+        _spinners.emplace_back(std::make_unique<ros::AsyncSpinner>(threads));
+
+        _logger << utils::Logger::Level::DEBUG
+                << "Spinning in 'async' mode, with "
+                << (threads ? std::to_string(threads) : std::string("one per core"))
+                << " threads and a timeout of " << timeout_ms << " ms" << std::endl;
+    }
+    else
+    {
+        _logger << utils::Logger::Level::ERROR
+                << "Unknown spin mode '" << mode << "'. Supported modes are "
+                << "'event', 'poll' and 'async'" << std::endl;
+
+        return false;
+    }
+
+    return true;
+}
+
+//==============================================================================
+bool SystemHandle::parse_transport_hints(
+        const YAML::Node& configuration,
+        ros::TransportHints& transport_hints)
+{
+    if (!configuration)
+    {
+        return true;
+    }
+
+    if (!configuration.IsMap())
+    {
+        _logger << utils::Logger::Level::ERROR
+                << "The 'transport_hints' section must be a map" << std::endl;
+
+        return false;
+    }
+
+    // The transports are tried in the order in which they are listed.
+    if (const YAML::Node transports = configuration["transports"])
+    {
+        if (!transports.IsSequence())
+        {
+            _logger << utils::Logger::Level::ERROR
+                    << "The 'transports' parameter of the 'transport_hints' section must be a list"
+                    << std::endl;
+
+            return false;
+        }
+
+        for (const YAML::Node& transport : transports)
+        {
+            const std::string transport_name = transport.IsScalar() ? transport.Scalar() : std::string();
+            if (transport_name == "reliable" || transport_name == "tcp")
+            {
+                transport_hints.reliable();
+            }
+            else if (transport_name == "unreliable" || transport_name == "udp")
+            {
+                transport_hints.unreliable();
+            }
+            else
+            {
+                _logger << utils::Logger::Level::ERROR
+                        << "Unknown transport '" << transport_name << "'. Supported transports are "
+                        << "'reliable' ('tcp') and 'unreliable' ('udp')" << std::endl;
+
+                return false;
+            }
+        }
+    }
+
+    bool tcp_nodelay = false;
+    int max_datagram_size = 0;
+    if (!read_option(_logger, "transport_hints", configuration, "tcp_nodelay", tcp_nodelay)
+            || !read_option(_logger, "transport_hints", configuration, "max_datagram_size", max_datagram_size))
+    {
+        return false;
+    }
+
+    if (configuration["tcp_nodelay"])
+    {
+        transport_hints.tcpNoDelay(tcp_nodelay);
+    }
+
+    if (configuration["max_datagram_size"])
+    {
+        transport_hints.maxDatagramSize(max_datagram_size);
+    }
+
+    return true;
+}
+
+//==============================================================================
+ros::NodeHandle& SystemHandle::make_dedicated_node(
+        uint32_t threads)
+{
+    _callback_queues.emplace_back(std::make_unique<ros::CallbackQueue>());
+    ros::CallbackQueue* queue = _callback_queues.back().get();
+
+    _dedicated_nodes.emplace_back(std::make_unique<ros::NodeHandle>(*_node));
+    _dedicated_nodes.back()->setCallbackQueue(queue);
+
+    _spinners.emplace_back(std::make_unique<ros::AsyncSpinner>(threads, queue));
+    if (_spinners_started)
+    {
+        _spinners.back()->start();
+    }
+
+    return *_dedicated_nodes.back();
+}
+
+//==============================================================================
+bool SystemHandle::configure_node_handles(
+        const YAML::Node& configuration)
+{
+    if (!configuration)
+    {
+        return true;
+    }
+
+    const uint32_t count = configuration["count"].as<uint32_t>(0);
+    const uint32_t threads = configuration["threads"].as<uint32_t>(1);
+    if (0 == threads)
+    {
+        _logger << utils::Logger::Level::ERROR
+                << "The 'threads' parameter of the 'node_handles' section must be greater than zero"
+                << std::endl;
+
+        return false;
+    }
+
+    // roscpp shares its connection and XML-RPC machinery among all the node handles
+    // of a process, so what they spread is the dispatching of the callbacks.
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        _node_pool.push_back(&make_dedicated_node(threads));
+    }
+
+    if (0 < count)
+    {
+        _logger << utils::Logger::Level::INFO
+                << "Spreading the topics and services across " << count << " node handles, served by "
+                << threads << " thread(s) each" << std::endl;
+    }
+
+    return true;
+}
+
+//==============================================================================
+ros::NodeHandle* SystemHandle::select_node(
+        const std::string& name,
+        const YAML::Node& configuration)
 {
+    if (const YAML::Node index = configuration["node_handle"])
+    {
+        const std::size_t i = index.as<std::size_t>();
+        if (i >= _node_pool.size())
+        {
+            _logger << utils::Logger::Level::ERROR
+                    << "Invalid 'node_handle' index " << i << " for '" << name << "': only "
+                    << _node_pool.size() << " node handles were configured" << std::endl;
+
+            return nullptr;
+        }
+
+        return _node_pool[i];
+    }
+
+    if (_node_pool.empty())
+    {
+        return _node.get();
+    }
+
+    return _node_pool[std::hash<std::string>()(name) % _node_pool.size()];
+}
+
+//==============================================================================
+bool SystemHandle::configure_metrics(
+        const YAML::Node& configuration)
+{
+    if (!configuration)
+    {
+        return true;
+    }
+
+    if (!configuration.IsMap())
+    {
+        _logger << utils::Logger::Level::ERROR
+                << "The 'metrics' section must be a map" << std::endl;
+
+        return false;
+    }
+
+    bool enabled = true;
+    uint32_t period_ms = 0;
+    std::string topic = "/diagnostics";
+    if (!read_option(_logger, "metrics", configuration, "enabled", enabled)
+            || !read_option(_logger, "metrics", configuration, "diagnostics_period_ms", period_ms)
+            || !read_option(_logger, "metrics", configuration, "diagnostics_topic", topic))
+    {
+        return false;
+    }
+
+    if (!enabled)
+    {
+        return true;
+    }
+
+    metrics_enabled() = true;
+
+    // In async mode the callbacks are dispatched by the spinner threads, and the spinning
+    // loop just sleeps, so there is nothing meaningful to record about it.
+    if (SpinMode::ASYNC != _spin_mode)
+    {
+        _spin_metrics = Metrics::instance().create("spin", ros::this_node::getName());
+    }
+
+    if (0 < period_ms)
+    {
+        _diagnostics_publisher = _node->advertise<diagnostic_msgs::DiagnosticArray>(topic, 1);
+        _diagnostics_timer = _node->createWallTimer(
+            ros::WallDuration(period_ms / 1000.0), &SystemHandle::publish_diagnostics, this);
+
+        _logger << utils::Logger::Level::DEBUG
+                << "Publishing the bridge metrics on topic '" << topic << "' every "
+                << period_ms << " ms" << std::endl;
+    }
+
+    return true;
+}
+
+//==============================================================================
+void SystemHandle::publish_diagnostics(
+        const ros::WallTimerEvent& /*event*/)
+{
+    std::vector<MetricsSnapshot> snapshot = Metrics::instance().snapshot();
+
+    std::unordered_map<std::string, const MetricsSnapshot*> previous;
+    for (const MetricsSnapshot& entity : _previous_snapshot)
+    {
+        previous[entity.kind + "/" + entity.name] = &entity;
+    }
+
+    diagnostic_msgs::DiagnosticArray diagnostics;
+    diagnostics.header.stamp = ros::Time::now();
+
+    struct MemoryUsage
+    {
+        int64_t bytes = 0;
+        std::size_t entities = 0;
+    };
+
+    std::map<std::string, MemoryUsage> memory_usage;
+
+    for (const MetricsSnapshot& entity : snapshot)
+    {
+        // Rates and percentiles cover the time since the previous publication.
+        MetricsSnapshot delta = entity;
+        double seconds = 0.0;
+
+        const auto it = previous.find(entity.kind + "/" + entity.name);
+        if (it != previous.end())
+        {
+            const MetricsSnapshot& before = *it->second;
+            delta.messages -= before.messages;
+            delta.bytes -= before.bytes;
+            delta.dropped -= before.dropped;
+            delta.errors -= before.errors;
+            for (std::size_t i = 0; i < Histogram::bucket_count; ++i)
+            {
+                delta.duration[i] -= before.duration[i];
+            }
+            seconds = std::chrono::duration<double>(entity.time - before.time).count();
+        }
+
+        diagnostic_msgs::DiagnosticStatus status;
+        status.name = "is_ros1/" + entity.kind + "/" + entity.name;
+        status.hardware_id = ros::this_node::getName();
+        status.level = (delta.dropped || delta.errors)
+                ? diagnostic_msgs::DiagnosticStatus::WARN
+                : diagnostic_msgs::DiagnosticStatus::OK;
+        status.message = (delta.dropped || delta.errors) ? "Dropping messages" : "OK";
+
+        auto add_value = [&](const std::string& key, double value)
+                {
+                    diagnostic_msgs::KeyValue key_value;
+                    key_value.key = key;
+                    key_value.value = std::to_string(value);
+                    status.values.push_back(std::move(key_value));
+                };
+
+        add_value("messages", static_cast<double>(entity.messages));
+        add_value("messages_per_second", seconds > 0.0 ? delta.messages / seconds : 0.0);
+        add_value("bytes_per_second", seconds > 0.0 ? delta.bytes / seconds : 0.0);
+        add_value("dropped", static_cast<double>(entity.dropped));
+        add_value("errors", static_cast<double>(entity.errors));
+
+        // The spins include the wait for callbacks, so they are not reported as a dispatching
+        // time, and the spinning loop has no notion of calls in flight.
+        const bool spin = ("spin" == entity.kind);
+        if (!spin)
+        {
+            add_value("in_flight", static_cast<double>(entity.in_flight));
+        }
+
+        const std::string duration = spin ? "spin_duration" : "duration";
+        add_value(duration + "_p50_us", Histogram::percentile(delta.duration, 0.50) / 1000.0);
+        add_value(duration + "_p99_us", Histogram::percentile(delta.duration, 0.99) / 1000.0);
+        add_value(duration + "_p999_us", Histogram::percentile(delta.duration, 0.999) / 1000.0);
+        add_value("memory_bytes", static_cast<double>(entity.memory));
+
+        diagnostics.status.push_back(std::move(status));
+
+        MemoryUsage& usage = memory_usage[entity.kind];
+        usage.bytes += entity.memory;
+        ++usage.entities;
+    }
+
+    // The memory usage report: one status per kind of entity, and one for the whole process.
+    memory_usage["types"] = MemoryUsage{static_cast<int64_t>(_types_memory), _type_count};
+
+    for (const auto& usage : memory_usage)
+    {
+        diagnostic_msgs::DiagnosticStatus status;
+        status.name = "is_ros1/memory/" + usage.first;
+        status.hardware_id = ros::this_node::getName();
+        status.level = diagnostic_msgs::DiagnosticStatus::OK;
+        status.message = "OK";
+
+        diagnostic_msgs::KeyValue bytes;
+        bytes.key = "memory_bytes";
+        bytes.value = std::to_string(usage.second.bytes);
+        status.values.push_back(std::move(bytes));
+
+        diagnostic_msgs::KeyValue entities;
+        entities.key = "entities";
+        entities.value = std::to_string(usage.second.entities);
+        status.values.push_back(std::move(entities));
+
+        diagnostics.status.push_back(std::move(status));
+    }
+
+    diagnostic_msgs::DiagnosticStatus process;
+    process.name = "is_ros1/memory/process";
+    process.hardware_id = ros::this_node::getName();
+    process.level = diagnostic_msgs::DiagnosticStatus::OK;
+    process.message = "OK";
+
+    diagnostic_msgs::KeyValue resident;
+    resident.key = "resident_bytes";
+    resident.value = std::to_string(Metrics::resident_memory());
+    process.values.push_back(std::move(resident));
+
+    diagnostics.status.push_back(std::move(process));
+
+    _diagnostics_publisher.publish(diagnostics);
+    _previous_snapshot = std::move(snapshot);
 }
 
 //==============================================================================
@@ -95,6 +549,50 @@ bool SystemHandle::configure(
         return false;
     }
 
+    if (!configure_spin(configuration["spin"]))
+    {
+        return false;
+    }
+
+    if (!configure_node_handles(configuration["node_handles"]))
+    {
+        return false;
+    }
+
+    if (!configure_metrics(configuration["metrics"]))
+    {
+        return false;
+    }
+
+    if (const YAML::Node yaml_message_log_level = configuration["message_log_level"])
+    {
+        const std::string level = yaml_message_log_level.as<std::string>();
+        if (level == "DEBUG")
+        {
+            hot_path_log_level() = utils::Logger::Level::DEBUG;
+        }
+        else if (level == "INFO")
+        {
+            hot_path_log_level() = utils::Logger::Level::INFO;
+        }
+        else if (level == "WARN")
+        {
+            hot_path_log_level() = utils::Logger::Level::WARN;
+        }
+        else if (level == "ERROR")
+        {
+            hot_path_log_level() = utils::Logger::Level::ERROR;
+        }
+        else
+        {
+            _logger << utils::Logger::Level::ERROR
+                    << "Unknown message_log_level '" << level << "'. Supported levels are "
+                    << "'DEBUG', 'INFO', 'WARN' and 'ERROR'" << std::endl;
+
+            return false;
+        }
+    }
+
     auto register_type = [&](const std::string& type_name) -> bool
             {
                 xtypes::DynamicType::Ptr type = Factory::instance().create_type(type_name);
@@ -117,26 +615,55 @@ bool SystemHandle::configure(
                 }
             };
 
+    // The types are not accounted one by one, so their footprint is the growth of the process
+    // while loading and registering them.
+    const uint64_t resident_before_types = Metrics::resident_memory();
+
+    // Find and load the .mix files of every required type up front, so that each of them
+    // is looked up and loaded only once.
+    MixLoader mix_loader(configuration["mix_path_cache"].as<std::string>(""));
+
+    for (const std::string& type : types.messages)
+    {
+        if (passthrough::g_msg_name != type)
+        {
+            mix_loader.add_message(type);
+        }
+    }
+
+    for (const std::string& type : types.services)
+    {
+        mix_loader.add_service(type.substr(0, type.find(":")));
+    }
+
+    mix_loader.run();
+
+    const auto register_start = std::chrono::steady_clock::now();
+
     // Add topic types to the TypeRegistry map, if present in the TypeFactory.
-    core::Search search("ros1");
     for (const std::string& type : types.messages)
     {
-        std::vector<std::string> checked_paths;
-        const std::string msg_mix_path =
-                search.find_message_mix(type, &checked_paths);
+        if (passthrough::g_msg_name == type)
+        {
+            // Built into this library, there is no mix file to load for it.
+            success &= register_type(type);
+            continue;
+        }
+
+        const MixLoader::Lookup& lookup = mix_loader.message(type);
 
-        if (msg_mix_path.empty())
+        if (lookup.path.empty())
         {
-            print_missing_mix_file("message", type, checked_paths);
+            print_missing_mix_file("message", type, lookup.checked_paths);
             success = false;
             continue;
         }
 
-        if (!core::Mix::from_file(msg_mix_path).load())
+        if (!lookup.loaded)
         {
             _logger << utils::Logger::Level::ERROR
                     << "Failed to load extension for message type '"
-                    << type << "' using mix file: " << msg_mix_path << std::endl;
+                    << type << "' using mix file: " << lookup.path << std::endl;
 
             success = false;
             continue;
@@ -145,7 +672,7 @@ bool SystemHandle::configure(
         {
             _logger << utils::Logger::Level::DEBUG
                     << "Loaded middleware interface extension for message type '"
-                    << type << "' using mix file: " << msg_mix_path << std::endl;
+                    << type << "' using mix file: " << lookup.path << std::endl;
 
             success &= register_type(type);
         }
@@ -155,23 +682,20 @@ bool SystemHandle::configure(
     for (const std::string& type : types.services)
     {
         const std::string library_name = type.substr(0, type.find(":"));
-        std::vector<std::string> checked_paths;
-
-        const std::string srv_mix_path =
-                search.find_service_mix(library_name, &checked_paths);
+        const MixLoader::Lookup& lookup = mix_loader.service(library_name);
 
-        if (srv_mix_path.empty())
+        if (lookup.path.empty())
         {
-            print_missing_mix_file("service", library_name, checked_paths);
+            print_missing_mix_file("service", library_name, lookup.checked_paths);
             success = false;
             continue;
         }
 
-        if (!core::Mix::from_file(srv_mix_path).load())
+        if (!lookup.loaded)
         {
             _logger << utils::Logger::Level::ERROR
                     << "Failed to load extension for service type '"
-                    << type << "' using mix file: " << srv_mix_path << std::endl;
+                    << type << "' using mix file: " << lookup.path << std::endl;
 
             success = false;
             continue;
@@ -180,12 +704,23 @@ bool SystemHandle::configure(
         {
             _logger << utils::Logger::Level::DEBUG
                     << "Loaded middleware interface extension for service type '"
-                    << type << "' using mix file: " << srv_mix_path << std::endl;
+                    << type << "' using mix file: " << lookup.path << std::endl;
 
             success &= register_type(type);
         }
     }
 
+    const uint64_t resident_after_types = Metrics::resident_memory();
+    _type_count = type_registry.size();
+    _types_memory = resident_after_types > resident_before_types
+            ? resident_after_types - resident_before_types : 0;
+
+    _logger << utils::Logger::Level::INFO
+            << "Registered " << type_registry.size() << " types in "
+            << std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - register_start).count()
+            << " ms, using " << _types_memory / 1024 << " KiB" << std::endl;
+
     return success;
 }
 
@@ -203,9 +738,48 @@ bool SystemHandle::okay() const
 //==============================================================================
 bool SystemHandle::spin_once()
 {
-    ros::Rate rate(10);
-    ros::spinOnce();
-    rate.sleep();
+    if (!_spinners_started)
+    {
+        // Spinners are started lazily so that no callback reaches the core
+        // before every subscription and service proxy has been created.
+        for (const std::unique_ptr<ros::AsyncSpinner>& spinner : _spinners)
+        {
+            spinner->start();
+        }
+        _spinners_started = true;
+    }
+
+    const MetricsStopwatch stopwatch;
+
+    switch (_spin_mode)
+    {
+        case SpinMode::EVENT:
+        {
+            // Block until some callback is ready, so that it gets dispatched as soon
+            // as it arrives, or until the timeout expires to let the core check okay().
+            ros::getGlobalCallbackQueue()->callAvailable(_spin_timeout);
+            break;
+        }
+        case SpinMode::POLL:
+        {
+            ros::spinOnce();
+            _spin_rate->sleep();
+            break;
+        }
+        case SpinMode::ASYNC:
+        {
+            // The global callback queue is served by the AsyncSpinner threads.
+            _spin_timeout.sleep();
+            break;
+        }
+    }
+
+    if (stopwatch.running() && _spin_metrics)
+    {
+        // The duration of a spin includes the time waiting for callbacks, so it is an upper
+        // bound of the dispatching time, which gets close to it only when the queue is busy.
+        _spin_metrics->record(0, stopwatch.elapsed_ns());
+    }
 
     return ros::ok();
 }
@@ -213,9 +787,19 @@ bool SystemHandle::spin_once()
 //==============================================================================
 SystemHandle::~SystemHandle()
 {
+    // Stop the spinner threads before destroying the entities they dispatch to.
+    for (const std::unique_ptr<ros::AsyncSpinner>& spinner : _spinners)
+    {
+        spinner->stop();
+    }
+
     _subscriptions.clear();
     _client_proxies.clear();
 
+    _spinners.clear();
+    _dedicated_nodes.clear();
+    _callback_queues.clear();
+
     _node->shutdown();
     _node.reset();
 
@@ -230,10 +814,41 @@ bool SystemHandle::subscribe(
         const YAML::Node& configuration)
 {
     int queue_size = configuration["queue_size"].as<int>(default_queue_size);
-    // TODO(MXG): Parse configuration so users can change transport hints
+    bool dedicated_thread = configuration["dedicated_thread"].as<bool>(false);
+
+    ros::TransportHints transport_hints;
+    if (!parse_transport_hints(configuration["transport_hints"], transport_hints))
+    {
+        _logger << utils::Logger::Level::ERROR
+                << "Failed to create subscription for topic '" << topic_name
+                << "': invalid 'transport_hints' configuration" << std::endl;
+
+        return false;
+    }
+
+    TopicOptions options;
+    std::string error;
+    if (!TopicOptions::parse(configuration, options, error))
+    {
+        _logger << utils::Logger::Level::ERROR
+                << "Failed to create subscription for topic '" << topic_name
+                << "': " << error << std::endl;
+
+        return false;
+    }
+
+    ros::NodeHandle* node = dedicated_thread
+            ? &make_dedicated_node()
+            : select_node(topic_name, configuration);
+
+    if (nullptr == node)
+    {
+        return false;
+    }
+
     auto subscription = Factory::instance().create_subscription(
-        message_type, *_node, topic_name,
-        callback, queue_size, ros::TransportHints());
+        message_type, *node, topic_name,
+        callback, queue_size, transport_hints, options);
 
     if (!subscription)
     {
@@ -252,7 +867,8 @@ bool SystemHandle::subscribe(
         _logger << utils::Logger::Level::INFO
                 << "Created subscription for topic '" << topic_name << "' with type '"
                 << message_type.name() << "' on node '" << ros::this_node::getName()
-                << "'" << std::endl;
+                << "'" << (dedicated_thread ? " with a dedicated callback thread" : "")
+                << std::endl;
 
         return true;
     }
@@ -262,8 +878,8 @@ bool SystemHandle::subscribe(
 bool SystemHandle::is_internal_message(
         void* /*filter_handle*/)
 {
-    // Always return false, since this should be handled by the ROS 1 SubscriptionCallback
-    // signature with the MessageEvent metadata about the received message instance.
+    // Always return false, since the local publications are discarded by the LoopbackFilter
+    // of each subscription, from the connection header of the received message instance.
     return false;
 }
 
@@ -278,20 +894,37 @@ std::shared_ptr<TopicPublisher> SystemHandle::advertise(
     int queue_size = configuration["queue_size"].as<int>(default_queue_size);
     bool latch_behavior = configuration["latch"].as<bool>(default_latch_behavior);
 
+    TopicOptions options;
+    std::string error;
+    if (!TopicOptions::parse(configuration, options, error))
+    {
+        _logger << utils::Logger::Level::ERROR
+                << "Failed to create publisher for topic '" << topic_name
+                << "': " << error << std::endl;
+
+        return publisher;
+    }
+
+    ros::NodeHandle* node = select_node(topic_name, configuration);
+    if (nullptr == node)
+    {
+        return publisher;
+    }
+
     if (topic_name.find('{') != std::string::npos)
     {
         // If the topic name contains a curly brace, we must assume that it needs
         // runtime substitutions.
         publisher = make_meta_publisher(
-            message_type, *_node, topic_name,
+            message_type, *node, topic_name,
             queue_size, latch_behavior,
-            configuration);
+            options, configuration);
     }
     else
     {
         publisher = Factory::instance().create_publisher(
-            message_type, *_node, topic_name,
-            queue_size, latch_behavior);
+            message_type, *node, topic_name,
+            queue_size, latch_behavior, options);
     }
 
     if (nullptr != publisher)
@@ -319,10 +952,23 @@ bool SystemHandle::create_client_proxy(
         const std::string& service_name,
         const xtypes::DynamicType& service_type,
         RequestCallback* callback,
-        const YAML::Node& /*configuration*/)
+        const YAML::Node& configuration)
 {
+    // The ROS 1 service callbacks wait for the reply of the remote server, so they
+    // are served from a dedicated queue to avoid blocking any other callback.
+    // Each thread of the queue allows one more request to be in flight.
+    const uint32_t threads = configuration["threads"].as<uint32_t>(default_service_threads);
+    if (0 == threads)
+    {
+        _logger << utils::Logger::Level::ERROR
+                << "Failed to create service client for service '" << service_name
+                << "': the 'threads' parameter must be greater than zero" << std::endl;
+
+        return false;
+    }
+
     auto client_proxy = Factory::instance().create_client_proxy(
-        service_type.name(), *_node, service_name, callback);
+        service_type.name(), make_dedicated_node(threads), service_name, callback, configuration);
 
     if (!client_proxy)
     {
@@ -340,7 +986,8 @@ bool SystemHandle::create_client_proxy(
         _logger << utils::Logger::Level::INFO
                 << "Created service client for service '" << service_name
                 << "' with type '" << service_type.name() << "' on node '"
-                << ros::this_node::getName() << "'" << std::endl;
+                << ros::this_node::getName() << "', serving up to " << threads
+                << " concurrent requests" << std::endl;
 
         _client_proxies.emplace_back(std::move(client_proxy));
         return true;
@@ -351,10 +998,16 @@ bool SystemHandle::create_client_proxy(
 std::shared_ptr<ServiceProvider> SystemHandle::create_service_proxy(
         const std::string& service_name,
         const xtypes::DynamicType& service_type,
-        const YAML::Node& /*configuration*/)
+        const YAML::Node& configuration)
 {
+    ros::NodeHandle* node = select_node(service_name, configuration);
+    if (nullptr == node)
+    {
+        return nullptr;
+    }
+
     auto server_proxy = Factory::instance().create_server_proxy(
-        service_type.name(), *_node, service_name);
+        service_type.name(), *node, service_name, configuration);
 
     if (!server_proxy)
     {
@@ -21,9 +21,14 @@
 
 #include <is/systemhandle/SystemHandle.hpp>
 
+#include <is/sh/ros1/Metrics.hpp>
+
 #include <is/utils/Log.hpp>
 
 #include <ros/node_handle.h>
+#include <ros/callback_queue.h>
+#include <ros/rate.h>
+#include <ros/spinner.h>
 
 namespace xtypes = eprosima::xtypes;
 
@@ -154,6 +159,112 @@ private:
             const std::string& type,
             const std::vector<std::string>& checked_paths);
 
+    /**
+     * @brief Parse the `spin` section of the SystemHandle configuration.
+     *
+     * @param[in] configuration The `spin` YAML node. It may be undefined,
+     *            in which case the default spinning mode is used.
+     *
+     * @returns `true` if the spinning configuration is valid, `false` otherwise.
+     */
+    bool configure_spin(
+            const YAML::Node& configuration);
+
+    /**
+     * @brief Parse the `metrics` section of the SystemHandle configuration.
+     *
+     * @param[in] configuration The `metrics` YAML node. It may be undefined,
+     *            in which case no metrics are recorded.
+     *
+     * @returns `true` if the metrics configuration is valid, `false` otherwise.
+     */
+    bool configure_metrics(
+            const YAML::Node& configuration);
+
+    /**
+     * @brief Publish a snapshot of the metrics of every bridged entity
+     *        as a `diagnostic_msgs/DiagnosticArray` message.
+     */
+    void publish_diagnostics(
+            const ros::WallTimerEvent& event);
+
+    /**
+     * @brief Parse the `transport_hints` section of a topic configuration.
+     *
+     * @param[in] configuration The `transport_hints` YAML node. It may be undefined,
+     *            in which case the default roscpp transport hints are kept.
+     *
+     * @param[out] transport_hints The transport hints to be filled.
+     *
+     * @returns `true` if the transport hints configuration is valid, `false` otherwise.
+     */
+    bool parse_transport_hints(
+            const YAML::Node& configuration,
+            ros::TransportHints& transport_hints);
+
+    /**
+     * @brief Create a node handle whose callbacks are served from its own
+     *        callback queue, by dedicated spinner threads.
+     *
+     * @param[in] threads The number of threads serving the callback queue.
+     *
+     * @returns A reference to the created node handle, owned by this SystemHandle.
+     */
+    ros::NodeHandle& make_dedicated_node(
+            uint32_t threads = 1);
+
+    /**
+     * @brief Parse the `node_handles` section of the SystemHandle configuration,
+     *        creating the pool of node handles the entities are spread across.
+     *
+     * @param[in] configuration The `node_handles` YAML node. It may be undefined,
+     *            in which case every entity is held by the main node handle.
+     *
+     * @returns `true` if the node handles configuration is valid, `false` otherwise.
+     */
+    bool configure_node_handles(
+            const YAML::Node& configuration);
+
+    /**
+     * @brief Choose the node handle that holds a topic or service.
+     *
+     * @details The `node_handle` index of the entity configuration is honored if present.
+     *          Otherwise, the name of the entity is hashed, so that each name always lands
+     *          on the same node handle of the pool.
+     *
+     * @param[in] name The topic or service name.
+     *
+     * @param[in] configuration The topic or service specific configuration.
+     *
+     * @returns A pointer to the node handle, or `nullptr` if the requested index is not valid.
+     */
+    ros::NodeHandle* select_node(
+            const std::string& name,
+            const YAML::Node& configuration);
+
+    /**
+     * @brief Strategy followed by spin_once() to dispatch the ROS 1 callbacks.
+     */
+    enum class SpinMode
+    {
+        /**
+         * Wait on the global callback queue until a callback is available,
+         * or the configured timeout expires, and dispatch it right away.
+         */
+        EVENT,
+
+        /**
+         * Dispatch all the available callbacks and then sleep until the
+         * configured period has elapsed, as a fixed-rate polling loop.
+         */
+        POLL,
+
+        /**
+         * Serve the global callback queue from a pool of ros::AsyncSpinner threads.
+         */
+        ASYNC
+    };
+
     /**
      * Class members.
      */
@@ -164,6 +275,28 @@ private:
 
     const uint32_t default_queue_size = 10;
     const bool default_latch_behavior = false;
+    const uint32_t default_spin_timeout_ms = 100;
+    const uint32_t default_spin_period_ms = 100;
+    const uint32_t default_service_threads = 4;
+
+    SpinMode _spin_mode;
+    ros::WallDuration _spin_timeout;
+    std::unique_ptr<ros::WallRate> _spin_rate;
+
+    std::vector<std::unique_ptr<ros::CallbackQueue> > _callback_queues;
+    std::vector<std::unique_ptr<ros::NodeHandle> > _dedicated_nodes;
+    std::vector<std::unique_ptr<ros::AsyncSpinner> > _spinners;
+    bool _spinners_started;
+
+    std::vector<ros::NodeHandle*> _node_pool;
+
+    std::shared_ptr<EntityMetrics> _spin_metrics;
+    ros::Publisher _diagnostics_publisher;
+    ros::WallTimer _diagnostics_timer;
+    std::vector<MetricsSnapshot> _previous_snapshot;
+
+    std::size_t _type_count = 0;
+    uint64_t _types_memory = 0;
 
     utils::Logger _logger;
 };
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2020 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <is/sh/ros1/TopicOptions.hpp>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace ros1 {
+
+//==============================================================================
+bool SharedMemoryOptions::parse(
+        const YAML::Node& configuration,
+        SharedMemoryOptions& options,
+        std::string& error)
+{
+    options = SharedMemoryOptions();
+    if (!configuration)
+    {
+        return true;
+    }
+
+    options.enabled = true;
+    options.segment = configuration["segment"].as<std::string>("");
+    options.slots = configuration["slots"].as<uint32_t>(options.slots);
+    options.slot_size = configuration["slot_size"].as<uint32_t>(options.slot_size);
+
+    if (configuration["segment"] && (options.segment.empty() || options.segment.find('/') != std::string::npos))
+    {
+        error = "the 'segment' name must not be empty nor contain slashes";
+        return false;
+    }
+
+    if (0 == options.slots || 0 == options.slot_size)
+    {
+        error = "'slots' and 'slot_size' must be greater than zero";
+        return false;
+    }
+
+    return true;
+}
+
+//==============================================================================
+SharedMemoryOptions SharedMemoryOptions::for_topic(
+        const std::string& topic_name) const
+{
+    SharedMemoryOptions options = *this;
+    if (options.segment.empty())
+    {
+        // By default, the segment name is made from the topic name, so that both ends agree on it.
+        options.segment = "is_ros1" + topic_name;
+        for (char& c : options.segment)
+        {
+            if (c == '/')
+            {
+                c = '_';
+            }
+        }
+    }
+
+    return options;
+}
+
+namespace {
+
+//==============================================================================
+bool parse_topic_options(
+        const YAML::Node& configuration,
+        TopicOptions& options,
+        std::string& error)
+{
+    options = TopicOptions();
+
+    if (!DeliveryOptions::parse(configuration["delivery"], options.delivery, error))
+    {
+        error = "invalid 'delivery' configuration, " + error;
+        return false;
+    }
+
+    if (!OverflowOptions::parse(configuration, options.overflow, error))
+    {
+        error = "invalid 'overflow_policy' configuration, " + error;
+        return false;
+    }
+
+    if (!SharedMemoryOptions::parse(configuration["shared_memory"], options.shared_memory, error))
+    {
+        error = "invalid 'shared_memory' configuration, " + error;
+        return false;
+    }
+
+    if (const YAML::Node history_depth = configuration["history_depth"])
+    {
+        // The fallback is only taken if the value is not an integer.
+        const int value = history_depth.as<int>(-1);
+        if (value < 0)
+        {
+            error = "invalid 'history_depth' configuration, it must be a non-negative integer";
+            return false;
+        }
+
+        options.history_depth = static_cast<std::size_t>(value);
+    }
+
+    if (0 < options.history_depth && options.shared_memory.enabled)
+    {
+        error = "the 'history_depth' and 'shared_memory' options cannot be combined, "
+                "since the shared memory slots are reused";
+        return false;
+    }
+
+    options.fanout_cache = configuration["fanout_cache"].as<bool>(false);
+    return true;
+}
+
+} //  anonymous namespace
+
+//==============================================================================
+bool TopicOptions::parse(
+        const YAML::Node& configuration,
+        TopicOptions& options,
+        std::string& error)
+{
+    // A value of the wrong kind, such as a map where a scalar is expected, makes yaml-cpp
+    // throw. It is rejected like any other invalid option, instead of leaving the SystemHandle.
+    try
+    {
+        return parse_topic_options(configuration, options, error);
+    }
+    catch (const YAML::Exception& e)
+    {
+        options = TopicOptions();
+        error = "malformed topic configuration, " + std::string(e.what());
+        return false;
+    }
+}
+
+} //  namespace ros1
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2020 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <ros/master.h>
+#include <ros/this_node.h>
+#include <ros/xmlrpc_manager.h>
+
+#include <is/sh/mock/api.hpp>
+#include <is/core/Instance.hpp>
+
+#include <yaml-cpp/yaml.h>
+
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <string>
+
+namespace is = eprosima::is;
+namespace xtypes = eprosima::xtypes;
+
+namespace {
+
+/**
+ * A ROS 1 service server that never answers: it listens, but never accepts. The kernel
+ * completes the connections of the callers anyway, so their calls hang waiting for a reply.
+ */
+class HungServer
+{
+public:
+
+    HungServer()
+        : _socket(::socket(AF_INET, SOCK_STREAM, 0))
+    {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+
+        socklen_t length = sizeof(address);
+        if (0 <= _socket
+                && 0 == ::bind(_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address))
+                && 0 == ::listen(_socket, 16)
+                && 0 == ::getsockname(_socket, reinterpret_cast<sockaddr*>(&address), &length))
+        {
+            _port = ntohs(address.sin_port);
+        }
+    }
+
+    ~HungServer()
+    {
+        // Closing it resets the pending connections, so it is kept open until the end of the test.
+        if (0 <= _socket)
+        {
+            ::close(_socket);
+        }
+    }
+
+    bool ok() const
+    {
+        return 0 != _port;
+    }
+
+    /**
+     * Register the service in the ROS master, on behalf of the node of the bridge.
+     */
+    bool advertise(
+            const std::string& service)
+    {
+        XmlRpc::XmlRpcValue request, response, payload;
+        request[0] = ros::this_node::getName();
+        request[1] = service;
+        request[2] = "rosrpc://127.0.0.1:" + std::to_string(_port);
+        request[3] = ros::XMLRPCManager::instance()->getServerURI();
+
+        return ros::master::execute("registerService", request, response, payload, false);
+    }
+
+    bool unadvertise(
+            const std::string& service)
+    {
+        XmlRpc::XmlRpcValue request, response, payload;
+        request[0] = ros::this_node::getName();
+        request[1] = service;
+        request[2] = "rosrpc://127.0.0.1:" + std::to_string(_port);
+
+        return ros::master::execute("unregisterService", request, response, payload, false);
+    }
+
+private:
+
+    int _socket;
+
+    uint16_t _port = 0;
+};
+
+} //  anonymous namespace
+
+TEST(ROS1_srv, Quit_while_a_ros1_service_call_hangs)
+{
+    using namespace std::chrono_literals;
+
+    HungServer server;
+    ASSERT_TRUE(server.ok());
+
+    YAML::Node config_node = YAML::LoadFile(ROS1__HUNG_SERVICE__TEST_CONFIG);
+
+    // We add the build directory that any unfound mix packages may have been
+    // built in, so that they can be found by the application.
+    is::core::InstanceHandle handle = is::run_instance(
+        config_node, {ROS1__GENMSG__BUILD_DIR});
+    ASSERT_TRUE(handle);
+
+    ASSERT_TRUE(server.advertise("hung_plan"));
+
+    const is::TypeRegistry& ros1_types = *handle.type_registry("ros1");
+    const xtypes::DynamicType& request_type = *ros1_types.at("nav_msgs/GetPlan:request");
+    const xtypes::DynamicData request_msg(request_type);
+
+    // Send it once: the call hangs until the timeout answers it with the error response.
+    auto future_response_msg = is::sh::mock::request("hung_plan", request_msg, 30s);
+    ASSERT_EQ(future_response_msg.wait_for(5s), std::future_status::ready);
+
+    // The worker is still waiting for the hung server, and must not block the shutdown.
+    ASSERT_TRUE(server.unadvertise("hung_plan"));
+    ASSERT_EQ(handle.quit().wait_for(5s), std::future_status::ready);
+
+    ASSERT_TRUE(!handle.running());
+    ASSERT_EQ(handle.wait(), 0);
+}
+
+int main(
+        int argc,
+        char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2020 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <is/sh/ros1/utilities.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace xtypes = eprosima::xtypes;
+namespace ros1 = eprosima::is::sh::ros1;
+
+namespace {
+
+std::atomic<bool> count_allocations(false);
+std::atomic<std::size_t> allocations(0);
+
+} // anonymous namespace
+
+void* operator new(
+        std::size_t size)
+{
+    if (count_allocations)
+    {
+        ++allocations;
+    }
+
+    void* ptr = std::malloc(size ? size : 1);
+    if (nullptr == ptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(
+        void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(
+        void* ptr,
+        std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+/**
+ * The generated Subscription builds its DynamicData once and refills it in place for
+ * every incoming message. For fixed-size types, that refill must not touch the heap.
+ */
+TEST(ROS1DynamicDataReuse, Refill_fixed_size_time_without_allocations)
+{
+    const xtypes::StructType time_type = ros1::convert__msg__Timebase::type("Time");
+    xtypes::DynamicData data(time_type);
+
+    ros::Time stamp(1, 2);
+    ros1::convert__msg__Time::convert_to_xtype(stamp, data);
+
+    allocations = 0;
+    count_allocations = true;
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        stamp.sec = i;
+        stamp.nsec = i * 1000;
+        ros1::convert__msg__Time::convert_to_xtype(stamp, data);
+    }
+    count_allocations = false;
+
+    EXPECT_EQ(0u, allocations.load());
+    EXPECT_EQ(999, data["sec"].value<int32_t>());
+    EXPECT_EQ(999000u, data["nanosec"].value<uint32_t>());
+}
+
+TEST(ROS1DynamicDataReuse, Refill_fixed_size_duration_without_allocations)
+{
+    const xtypes::StructType duration_type = ros1::convert__msg__Timebase::type("Duration");
+    xtypes::DynamicData data(duration_type);
+
+    ros::Duration duration(1, 2);
+    ros1::convert__msg__Duration::convert_to_xtype(duration, data);
+
+    allocations = 0;
+    count_allocations = true;
+    for (int32_t i = 0; i < 1000; ++i)
+    {
+        duration.sec = i;
+        duration.nsec = -1;
+        ros1::convert__msg__Duration::convert_to_xtype(duration, data);
+    }
+    count_allocations = false;
+
+    EXPECT_EQ(0u, allocations.load());
+    EXPECT_EQ(998, data["sec"].value<int32_t>());
+    EXPECT_EQ(999999999u, data["nanosec"].value<uint32_t>());
+}
+
+int main(
+        int argc,
+        char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
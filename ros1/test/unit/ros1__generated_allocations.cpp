@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2020 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <is/genmsg/ros1/geometry_msgs/msg/convert__msg__Pose.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace xtypes = eprosima::xtypes;
+namespace ros1 = eprosima::is::sh::ros1;
+
+namespace {
+
+std::atomic<bool> count_allocations(false);
+std::atomic<std::size_t> allocations(0);
+
+} // anonymous namespace
+
+void* operator new(
+        std::size_t size)
+{
+    if (count_allocations)
+    {
+        ++allocations;
+    }
+
+    void* ptr = std::malloc(size ? size : 1);
+    if (nullptr == ptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(
+        void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(
+        void* ptr,
+        std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+/**
+ * The generated converters of a fixed-size message, nested messages included, must refill
+ * the DynamicData that the generated Subscription reuses without touching the heap.
+ */
+TEST(ROS1GeneratedAllocations, Refill_fixed_size_pose_without_allocations)
+{
+    namespace pose = ros1::convert__geometry_msgs__msg__Pose;
+
+    xtypes::DynamicData data(pose::type());
+
+    geometry_msgs::Pose msg;
+    msg.orientation.w = 1.0;
+    pose::convert_to_xtype(msg, data);
+
+    allocations = 0;
+    count_allocations = true;
+    for (int i = 0; i < 1000; ++i)
+    {
+        msg.position.x = i;
+        msg.position.y = 2.0 * i;
+        msg.orientation.z = 0.5 * i;
+        pose::convert_to_xtype(msg, data);
+    }
+    count_allocations = false;
+
+    EXPECT_EQ(0u, allocations.load());
+    EXPECT_EQ(999.0, data["position"]["x"].value<double>());
+    EXPECT_EQ(1998.0, data["position"]["y"].value<double>());
+    EXPECT_EQ(499.5, data["orientation"]["z"].value<double>());
+    EXPECT_EQ(1.0, data["orientation"]["w"].value<double>());
+}
+
+int main(
+        int argc,
+        char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
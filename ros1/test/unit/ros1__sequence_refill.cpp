@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2020 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <is/genmsg/ros1/sensor_msgs/msg/convert__msg__JointState.hpp>
+#include <is/genmsg/ros1/sensor_msgs/msg/convert__msg__PointCloud2.hpp>
+
+#include <gtest/gtest.h>
+
+namespace xtypes = eprosima::xtypes;
+namespace ros1 = eprosima::is::sh::ros1;
+
+/**
+ * The generated Subscription refills the same DynamicData instance for every incoming message,
+ * so a message with shorter sequences than the previous one must not keep its trailing elements.
+ */
+TEST(ROS1SequenceRefill, Refill_string_and_primitive_sequences_with_fewer_elements)
+{
+    namespace joint_state = ros1::convert__sensor_msgs__msg__JointState;
+
+    xtypes::DynamicData data(joint_state::type());
+
+    sensor_msgs::JointState long_msg;
+    long_msg.name = {"shoulder", "elbow", "wrist"};
+    long_msg.position = {1.0, 2.0, 3.0};
+    joint_state::convert_to_xtype(long_msg, data);
+
+    ASSERT_EQ(3u, data["name"].size());
+    ASSERT_EQ(3u, data["position"].size());
+
+    sensor_msgs::JointState short_msg;
+    short_msg.name = {"gripper"};
+    short_msg.position = {4.0};
+    joint_state::convert_to_xtype(short_msg, data);
+
+    ASSERT_EQ(1u, data["name"].size());
+    EXPECT_EQ("gripper", data["name"][0].value<std::string>());
+    ASSERT_EQ(1u, data["position"].size());
+    EXPECT_EQ(4.0, data["position"][0].value<double>());
+
+    sensor_msgs::JointState converted;
+    joint_state::convert_to_ros1(data, converted);
+    EXPECT_EQ(short_msg.name, converted.name);
+    EXPECT_EQ(short_msg.position, converted.position);
+}
+
+TEST(ROS1SequenceRefill, Refill_nested_message_sequences_with_fewer_elements)
+{
+    namespace point_cloud = ros1::convert__sensor_msgs__msg__PointCloud2;
+
+    xtypes::DynamicData data(point_cloud::type());
+
+    sensor_msgs::PointCloud2 long_msg;
+    long_msg.fields.resize(4);
+    const char* names[] = {"x", "y", "z", "rgb"};
+    for (std::size_t i = 0; i < long_msg.fields.size(); ++i)
+    {
+        long_msg.fields[i].name = names[i];
+        long_msg.fields[i].offset = static_cast<uint32_t>(4 * i);
+    }
+    point_cloud::convert_to_xtype(long_msg, data);
+
+    ASSERT_EQ(4u, data["fields"].size());
+
+    sensor_msgs::PointCloud2 short_msg;
+    short_msg.fields.resize(1);
+    short_msg.fields[0].name = "intensity";
+    short_msg.fields[0].offset = 0;
+    point_cloud::convert_to_xtype(short_msg, data);
+
+    ASSERT_EQ(1u, data["fields"].size());
+    EXPECT_EQ("intensity", data["fields"][0]["name"].value<std::string>());
+
+    sensor_msgs::PointCloud2 converted;
+    point_cloud::convert_to_ros1(data, converted);
+    ASSERT_EQ(1u, converted.fields.size());
+    EXPECT_EQ("intensity", converted.fields[0].name);
+}
+
+int main(
+        int argc,
+        char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
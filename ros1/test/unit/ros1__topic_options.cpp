@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2020 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <is/sh/ros1/TopicOptions.hpp>
+
+#include <gtest/gtest.h>
+
+namespace ros1 = eprosima::is::sh::ros1;
+
+/**
+ * The topic options come straight from the user configuration, so values of the wrong kind
+ * must be rejected through the error message, like any other invalid option, and never throw.
+ */
+TEST(ROS1TopicOptions, Reject_a_non_numeric_history_depth)
+{
+    ros1::TopicOptions options;
+    std::string error;
+
+    EXPECT_FALSE(ros1::TopicOptions::parse(YAML::Load("history_depth: many"), options, error));
+    EXPECT_NE(std::string::npos, error.find("'history_depth'"));
+
+    error.clear();
+    EXPECT_FALSE(ros1::TopicOptions::parse(YAML::Load("history_depth: [1, 2]"), options, error));
+    EXPECT_NE(std::string::npos, error.find("'history_depth'"));
+
+    error.clear();
+    EXPECT_FALSE(ros1::TopicOptions::parse(YAML::Load("history_depth: -1"), options, error));
+    EXPECT_NE(std::string::npos, error.find("'history_depth'"));
+
+    ASSERT_TRUE(ros1::TopicOptions::parse(YAML::Load("history_depth: 5"), options, error));
+    EXPECT_EQ(5u, options.history_depth);
+}
+
+TEST(ROS1TopicOptions, Reject_options_of_the_wrong_kind)
+{
+    ros1::TopicOptions options;
+    std::string error;
+
+    EXPECT_FALSE(ros1::TopicOptions::parse(YAML::Load("delivery: batch"), options, error));
+    EXPECT_FALSE(error.empty());
+
+    error.clear();
+    EXPECT_FALSE(ros1::TopicOptions::parse(YAML::Load("shared_memory: {segment: {a: b}}"), options, error));
+    EXPECT_FALSE(error.empty());
+}
+
+TEST(ROS1TopicOptions, Reject_an_overflow_policy_that_is_not_a_string)
+{
+    ros1::TopicOptions options;
+    std::string error;
+
+    EXPECT_FALSE(ros1::TopicOptions::parse(YAML::Load("overflow_policy: [drop_oldest]"), options, error));
+    EXPECT_NE(std::string::npos, error.find("'overflow_policy'"));
+
+    error.clear();
+    EXPECT_FALSE(ros1::TopicOptions::parse(YAML::Load("overflow_policy: {block: true}"), options, error));
+    EXPECT_NE(std::string::npos, error.find("'overflow_policy'"));
+
+    ASSERT_TRUE(ros1::TopicOptions::parse(YAML::Load("overflow_policy: block"), options, error));
+    EXPECT_TRUE(options.overflow.enabled);
+    EXPECT_EQ(ros1::OverflowOptions::Policy::BLOCK, options.overflow.policy);
+}
+
+int main(
+        int argc,
+        char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
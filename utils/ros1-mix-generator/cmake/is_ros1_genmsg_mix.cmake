@@ -22,6 +22,9 @@ include(GNUInstallDirs)
 #   MIDDLEWARES [ros1|websocket|hl7]...
 #   [QUIET]
 #   [REQUIRED]
+#   [STRIP_HOT_PATH_LOGS]
+#   [TRACEPOINTS]
+#   [UNITY_BUILD]
 # )
 #
 # Generate an Integration Service middleware interface extension for a set of genmsg packages.
@@ -47,13 +50,36 @@ include(GNUInstallDirs)
 # mix libraries from being generated. If REQUIRED is not specified, then this
 # function will instead print warnings and proceed as much as possible whenever
 # an error is encountered.
+#
+# Use the STRIP_HOT_PATH_LOGS option, or enable the IS_ROS1_STRIP_HOT_PATH_LOGS
+# variable, to remove at compile time the per-message log traces of the generated
+# publishers, subscriptions and service proxies. The definition only applies to the
+# mix libraries created by this call, which requires CMake 3.7 or newer; with older
+# versions, it applies to every target of the calling directory, as add_definitions() does.
+#
+# Use the TRACEPOINTS option, or enable the IS_ROS1_TRACEPOINTS variable, to compile the USDT
+# tracepoints of the generated publishers, subscriptions and service proxies, which perf,
+# bpftrace, SystemTap or LTTng can attach to. Requires the <sys/sdt.h> header, provided by
+# the systemtap-sdt-dev package; otherwise, a warning is printed and the tracepoints are left out.
+# As with STRIP_HOT_PATH_LOGS, the definition only applies to the mix libraries created by this call.
+#
+# Use the UNITY_BUILD option, or enable the IS_ROS1_GENMSG_UNITY_BUILD variable, to compile
+# the generated converters of each package as a few unity (jumbo) translation units, so that
+# the ROS headers are parsed once per batch rather than once per type. The batch size is taken
+# from IS_ROS1_GENMSG_UNITY_BATCH_SIZE, which defaults to 0, that is, one translation unit
+# per package. Requires CMake 3.16 or newer.
+#
+# The generation script leaves untouched the files whose content does not change, and skips
+# rendering the ones whose inputs did not change since the previous run, so only the converters
+# of the modified specifications are compiled again. It renders the idl files in parallel,
+# with as many processes as the IS_ROS1_GENMSG_JOBS environment variable tells, or one per core.
 function(is_ros1_genmsg_mix)
 
     set(possible_options QUIET REQUIRED)
 
     cmake_parse_arguments(
         _ARG # prefix
-        "${possible_options}" # options
+        "${possible_options};STRIP_HOT_PATH_LOGS;TRACEPOINTS;UNITY_BUILD" # options
         "" # one-value arguments
         "PACKAGES;MIDDLEWARES" # multi-value arguments
         ${ARGN}
@@ -66,6 +92,48 @@ function(is_ros1_genmsg_mix)
         endif()
     endforeach()
 
+    # The compile definitions for the mix libraries created by this call.
+    set(mix_definitions)
+
+    if(_ARG_STRIP_HOT_PATH_LOGS OR IS_ROS1_STRIP_HOT_PATH_LOGS)
+        list(APPEND mix_definitions IS_ROS1_STRIP_HOT_PATH_LOGS)
+    endif()
+
+    if(_ARG_TRACEPOINTS OR IS_ROS1_TRACEPOINTS)
+        include(CheckIncludeFileCXX)
+        check_include_file_cxx(sys/sdt.h IS_ROS1_HAVE_SYS_SDT_H)
+        if(IS_ROS1_HAVE_SYS_SDT_H)
+            list(APPEND mix_definitions IS_ROS1_TRACEPOINTS)
+        else()
+            message(WARNING "The tracepoints of the mix libraries require <sys/sdt.h>, ignoring them")
+        endif()
+    endif()
+
+    if(_ARG_UNITY_BUILD OR IS_ROS1_GENMSG_UNITY_BUILD)
+        if(CMAKE_VERSION VERSION_LESS 3.16)
+            message(WARNING "Unity builds of the mix libraries require CMake 3.16 or newer, ignoring it")
+        else()
+            # Every generated type lives in its own namespace, so the generated sources can be
+            # merged into the same translation unit. The variables initialize the properties
+            # of the targets created by is_mix_generator() from this very function.
+            set(CMAKE_UNITY_BUILD ON)
+            if(DEFINED IS_ROS1_GENMSG_UNITY_BATCH_SIZE)
+                set(CMAKE_UNITY_BUILD_BATCH_SIZE ${IS_ROS1_GENMSG_UNITY_BATCH_SIZE})
+            else()
+                set(CMAKE_UNITY_BUILD_BATCH_SIZE 0)
+            endif()
+        endif()
+    endif()
+
+    if(mix_definitions AND CMAKE_VERSION VERSION_LESS 3.7)
+        foreach(definition ${mix_definitions})
+            add_definitions(-D${definition})
+        endforeach()
+        set(mix_definitions)
+    endif()
+
+    get_property(targets_before DIRECTORY PROPERTY BUILDSYSTEM_TARGETS)
+
     is_mix_generator(
         IDL_TYPE
             genmsg
@@ -83,4 +151,25 @@ function(is_ros1_genmsg_mix)
         ${options}
     )
 
+    if(mix_definitions)
+        # is_mix_generator() creates the mix libraries in the calling directory.
+        get_property(mix_targets DIRECTORY PROPERTY BUILDSYSTEM_TARGETS)
+        if(targets_before)
+            list(REMOVE_ITEM mix_targets ${targets_before})
+        endif()
+
+        set(defined FALSE)
+        foreach(target ${mix_targets})
+            get_target_property(target_type ${target} TYPE)
+            if(target_type MATCHES "^(SHARED|STATIC|MODULE|OBJECT)_LIBRARY$")
+                target_compile_definitions(${target} PRIVATE ${mix_definitions})
+                set(defined TRUE)
+            endif()
+        endforeach()
+
+        if(NOT defined)
+            message(WARNING "No mix library was created by this call, ignoring the definitions ${mix_definitions}")
+        endif()
+    endif()
+
 endfunction()
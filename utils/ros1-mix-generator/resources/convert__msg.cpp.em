@@ -30,9 +30,45 @@ conversion_dependency = 'is/genmsg/ros1/{}/msg/convert__msg__{}.hpp'.format(
 // Include the Factory header so we can add this message type to the Factory
 #include <is/sh/ros1/Factory.hpp>
 
+// Include the header for the per-message log traces
+#include <is/sh/ros1/Log.hpp>
+
+// Include the header for forwarding ROS 1 messages between ROS 1 systems as they are
+#include <is/sh/ros1/DirectRoute.hpp>
+
+// Include the header for holding messages back until their delivery
+#include <is/sh/ros1/Delivery.hpp>
+
+// Include the header for the late-joiner history of the publishers
+#include <is/sh/ros1/HistoryCache.hpp>
+
+// Include the header for sharing the conversion of a message among its publishers
+#include <is/sh/ros1/SerializedCache.hpp>
+
+// Include the header for the bridge-side bounded queues
+#include <is/sh/ros1/OverflowQueue.hpp>
+
+// Include the header for the shared memory transport
+#include <is/sh/ros1/SharedMemory.hpp>
+
+// Include the header for the runtime metrics
+#include <is/sh/ros1/Metrics.hpp>
+
+// Include the header for the per-message tracepoints
+#include <is/sh/ros1/Tracing.hpp>
+
+// Include the header for filtering out the local publications
+#include <is/sh/ros1/LoopbackFilter.hpp>
+
 // Include the NodeHandle API so we can subscribe and advertise
 #include <ros/node_handle.h>
-#include <ros/this_node.h>
+
+// Include the message type of the shared memory handles
+#include <std_msgs/UInt64.h>
+
+// Include the STL API for std::mutex
+#include <memory>
+#include <mutex>
 
 // TODO(jamoralp): Add utils::Logger traces here
 namespace eprosima {
@@ -43,7 +79,7 @@ namespace @(namespace_variable) {
 
 //==============================================================================
 namespace {
-TypeToFactoryRegistrar register_type(g_msg_name, &type);
+TypeToFactoryRegistrar register_type(g_msg_name, &shared_type);
 } //  anonymous namespace
 
 //==============================================================================
@@ -57,15 +93,64 @@ public:
             const xtypes::DynamicType& message_type,
             TopicSubscriberSystem::SubscriptionCallback* callback,
             uint32_t queue_size,
-            const ros::TransportHints& transport_hints)
+            const ros::TransportHints& transport_hints,
+            const TopicOptions& options)
         : _topic(topic_name)
         , _callback(callback)
         , _message_type(message_type)
+        , _data(message_type)
+        , _metrics(Metrics::instance().create("subscription", topic_name))
+        , _trace(topic_name)
     {
+        _metrics->memory.store(static_cast<int64_t>(message_type.memory_size()), std::memory_order_relaxed);
+
+        if (DeliveryOptions::Mode::EACH != options.delivery.mode)
+        {
+            _delivery = std::make_unique<DeliveryBuffer>(
+                node, options.delivery, [this](const DeliveryBuffer::MsgConstPtr& msg)
+                {
+                    deliver(*static_cast<const Ros1_Msg*>(msg.get()), 0);
+                });
+        }
 
-        _subscription = node.subscribe(
-            topic_name, queue_size, &Subscription::subscription_callback, this,
-            transport_hints);
+        if (options.overflow.enabled)
+        {
+            _overflow = std::make_unique<OverflowQueue>(
+                options.overflow, [this](const OverflowQueue::MsgConstPtr& msg)
+                {
+                    forward(boost::static_pointer_cast<const Ros1_Msg>(msg), 0);
+                }, _metrics);
+        }
+
+        if (options.shared_memory.enabled)
+        {
+            // Only the handles of the messages go through the ROS 1 transport.
+            _shm = std::make_unique<SharedMemoryReader>(
+                options.shared_memory.for_topic(topic_name).segment,
+                ros::message_traits::md5sum<Ros1_Msg>());
+            _shm_msg = boost::make_shared<Ros1_Msg>();
+
+            ros::SubscribeOptions handle_options = make_loopback_filtering_options<std_msgs::UInt64>(
+                SharedMemoryOptions::handle_topic(topic_name), queue_size,
+                [this](const ros::MessageEvent<std_msgs::UInt64 const>& handle_event)
+                {
+                    handle_callback(handle_event);
+                },
+                _loopback_filter, transport_hints);
+
+            _subscription = node.subscribe(handle_options);
+            return;
+        }
+
+        ros::SubscribeOptions subscribe_options = make_loopback_filtering_options<Ros1_Msg>(
+            topic_name, queue_size,
+            [this](const ros::MessageEvent<Ros1_Msg const>& msg_event)
+            {
+                subscription_callback(msg_event);
+            },
+            _loopback_filter, transport_hints);
+
+        _subscription = node.subscribe(subscribe_options);
     }
 
 private:
@@ -73,31 +158,149 @@ private:
     void subscription_callback(
             const ros::MessageEvent<Ros1_Msg const>& msg_event)
     {
-        logger << utils::Logger::Level::INFO
-               << "Receiving message from ROS 1 for topic '"
-               << _topic << "'" << std::endl;
+        IS_ROS1_HOT_PATH_LOG(logger, utils::Logger::Level::INFO,
+                "Receiving message from ROS 1 for topic '" << _topic << "'");
 
-        if (ros::this_node::getName() == msg_event.getPublisherName())
+        // Local publications received through a connection are discarded before being
+        // deserialized, but intraprocess ones are handed over without that step.
+        if (_loopback_filter->is_local(msg_event.getConnectionHeaderPtr()))
         {
             // This is a local publication from within Integration Service. Return
             return;
         }
 
-        xtypes::DynamicData data(_message_type);
-        convert_to_xtype(*(msg_event.getMessage().get()), data);
+        IS_ROS1_TRACE_BEGIN(subscription_receive, _trace, sequence);
+        dispatch(msg_event.getMessage(), sequence);
+    }
+
+    void handle_callback(
+            const ros::MessageEvent<std_msgs::UInt64 const>& handle_event)
+    {
+        if (_loopback_filter->is_local(handle_event.getConnectionHeaderPtr()))
+        {
+            return;
+        }
+
+        const uint64_t handle = handle_event.getMessage()->data;
+        IS_ROS1_TRACE_BEGIN(subscription_receive, _trace, sequence);
+
+        std::string error;
+        if (!_shm->attach(handle, error))
+        {
+            logger << utils::Logger::Level::ERROR
+                   << "Dropping message for topic '" << _topic << "': " << error << std::endl;
+
+            _metrics->errors.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        // The messages held back for their delivery cannot share a buffer.
+        const boost::shared_ptr<Ros1_Msg> msg = (_delivery || _overflow)
+                ? boost::make_shared<Ros1_Msg>() : _shm_msg;
+
+        switch (_shm->read(handle, *msg))
+        {
+            case SharedMemoryRing::ReadResult::OK:
+                break;
+            case SharedMemoryRing::ReadResult::OVERWRITTEN:
+                IS_ROS1_HOT_PATH_LOG(logger, utils::Logger::Level::WARN,
+                        "Dropping message for topic '" << _topic
+                        << "': its shared memory slot was overwritten before being read");
+
+                _metrics->dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            case SharedMemoryRing::ReadResult::INVALID:
+                IS_ROS1_HOT_PATH_LOG(logger, utils::Logger::Level::WARN,
+                        "Dropping message for topic '" << _topic
+                        << "': invalid shared memory handle " << handle);
+
+                _metrics->errors.fetch_add(1, std::memory_order_relaxed);
+                return;
+        }
+
+        dispatch(msg, sequence);
+    }
 
-        logger << utils::Logger::Level::INFO
-               << "Received message: [[ " << data << " ]]" << std::endl;
+    /**
+     * The messages held back by a bridge-side queue or a delivery buffer lose their
+     * trace sequence number, and are traced with number 0 from then on.
+     */
+    void dispatch(
+            const boost::shared_ptr<const Ros1_Msg>& msg,
+            uint64_t sequence)
+    {
+        if (_overflow)
+        {
+            IS_ROS1_TRACE(subscription_queue, _trace, sequence);
+            _overflow->push(msg);
+        }
+        else
+        {
+            forward(msg, sequence);
+        }
+    }
 
-        (*_callback)(data, nullptr);
+    void forward(
+            const boost::shared_ptr<const Ros1_Msg>& msg,
+            uint64_t sequence)
+    {
+        if (_delivery)
+        {
+            IS_ROS1_TRACE(subscription_queue, _trace, sequence);
+            _delivery->push(msg);
+        }
+        else
+        {
+            deliver(*msg, sequence);
+        }
+    }
+
+    void deliver(
+            const Ros1_Msg& msg,
+            uint64_t sequence)
+    {
+        // roscpp never runs the callbacks of a single subscription concurrently, and the
+        // DeliveryBuffer never runs its handler concurrently either, so the same
+        // DynamicData instance can be refilled in place for every message.
+        const MetricsStopwatch stopwatch;
+        convert_to_xtype(msg, _data);
+        IS_ROS1_TRACE(subscription_converted, _trace, sequence);
+
+        if (stopwatch.running())
+        {
+            _metrics->record(ros::serialization::serializationLength(msg), stopwatch.elapsed_ns());
+        }
+
+        IS_ROS1_HOT_PATH_LOG(logger, utils::Logger::Level::INFO,
+                "Received message: [[ " << _data << " ]]");
+
+        // Let the ROS 1 publishers of this very type reuse the original message.
+        const DirectSourceScope direct_source_scope(_data, msg);
+        (*_callback)(_data, nullptr);
+        IS_ROS1_TRACE(subscription_delivered, _trace, sequence);
     }
 
     const std::string _topic;
 
     TopicSubscriberSystem::SubscriptionCallback* _callback;
 
+    const std::shared_ptr<LoopbackFilter> _loopback_filter = std::make_shared<LoopbackFilter>();
+
     const xtypes::DynamicType& _message_type;
 
+    xtypes::DynamicData _data;
+
+    const std::shared_ptr<EntityMetrics> _metrics;
+
+    EntityTraceContext _trace;
+
+    std::unique_ptr<DeliveryBuffer> _delivery;
+
+    std::unique_ptr<SharedMemoryReader> _shm;
+    boost::shared_ptr<Ros1_Msg> _shm_msg;
+
+    std::unique_ptr<OverflowQueue> _overflow;
+
     ros::Subscriber _subscription;
 };
 
@@ -108,10 +311,11 @@ std::shared_ptr<void> subscribe(
         const xtypes::DynamicType& message_type,
         TopicSubscriberSystem::SubscriptionCallback* callback,
         const uint32_t queue_size,
-        const ros::TransportHints& transport_hints)
+        const ros::TransportHints& transport_hints,
+        const TopicOptions& options)
 {
     return std::make_shared<Subscription>(
-        node, topic_name, message_type, callback, queue_size, transport_hints);
+        node, topic_name, message_type, callback, queue_size, transport_hints, options);
 }
 
 //==============================================================================
@@ -128,30 +332,290 @@ public:
             ros::NodeHandle& node,
             const std::string& topic_name,
             uint32_t queue_size,
-            bool latch)
+            bool latch,
+            const TopicOptions& options,
+            std::unique_ptr<SharedMemoryRing> shm_ring)
         : _topic_name(topic_name)
+        , _metrics(Metrics::instance().create("publisher", topic_name))
+        , _trace(topic_name)
+        , _fanout_cache(options.fanout_cache && !shm_ring)
+        , _shm_ring(std::move(shm_ring))
     {
-        _publisher = node.advertise<Ros1_Msg>(topic_name, queue_size, latch);
+        if (_shm_ring)
+        {
+            // Only the handles of the messages go through the ROS 1 transport.
+            _publisher = node.advertise<std_msgs::UInt64>(
+                SharedMemoryOptions::handle_topic(topic_name), queue_size, latch);
+        }
+        else if (0 < options.history_depth)
+        {
+            // The history is replayed to each subscriber as soon as it connects, which
+            // already covers the last message, so the topic is not latched on top of it.
+            _history = std::make_unique<HistoryCache<Ros1_Msg> >(options.history_depth, _metrics);
+            _publisher = node.advertise(ros::AdvertiseOptions::create<Ros1_Msg>(
+                        topic_name, queue_size,
+                        [this](const ros::SingleSubscriberPublisher& subscriber)
+                        {
+                            _history->replay(subscriber);
+                        },
+                        ros::SubscriberStatusCallback(), ros::VoidConstPtr(), nullptr));
+        }
+        else
+        {
+            _publisher = node.advertise<Ros1_Msg>(topic_name, queue_size, latch);
+        }
+
+        if (DeliveryOptions::Mode::EACH != options.delivery.mode)
+        {
+            // A whole batch is published at once, holding the delivery lock only once.
+            _delivery = std::make_unique<DeliveryBuffer>(
+                node, options.delivery, [this](const DeliveryBuffer::MsgConstPtr& msg)
+                {
+                    send(*static_cast<const Ros1_Msg*>(msg.get()), 0);
+                });
+        }
+
+        if (options.overflow.enabled)
+        {
+            // With the 'block' policy, Integration Service waits here for the ROS 1 side.
+            _overflow = std::make_unique<OverflowQueue>(
+                options.overflow, [this](const OverflowQueue::MsgConstPtr& msg)
+                {
+                    forward(boost::static_pointer_cast<const Ros1_Msg>(msg));
+                }, _metrics);
+        }
+    }
+
+    ~Publisher() override
+    {
+        // Publish whatever is still queued or held back before going away.
+        _overflow.reset();
+
+        if (_delivery)
+        {
+            _delivery->flush();
+        }
     }
 
+    /**
+     * The messages held back by a bridge-side queue or a delivery buffer lose their
+     * trace sequence number, and are traced with number 0 from then on.
+     */
     bool publish(
             const xtypes::DynamicData& message) override
     {
-        Ros1_Msg ros1_msg;
-        convert_to_ros1(message, ros1_msg);
+        IS_ROS1_TRACE_BEGIN(publisher_publish, _trace, sequence);
 
-        logger << utils::Logger::Level::INFO
-                << "Sending message from Integration Service to ROS 1 for topic '" << _topic_name << "': "
-                << "[[ " << message << " ]]" << std::endl;
+        // Messages coming from a ROS 1 subscription of the same type are published as they
+        // were received, without converting them back.
+        if (const Ros1_Msg* source = direct_source<Ros1_Msg>(message))
+        {
+            IS_ROS1_HOT_PATH_LOG(logger, utils::Logger::Level::INFO,
+                    "Forwarding message from ROS 1 to ROS 1 for topic '" << _topic_name << "'");
+
+            if (metrics_enabled().load(std::memory_order_relaxed))
+            {
+                _metrics->record(ros::serialization::serializationLength(*source), 0);
+            }
+
+            if (_overflow)
+            {
+                IS_ROS1_TRACE(publisher_queue, _trace, sequence);
+                return _overflow->push(boost::make_shared<const Ros1_Msg>(*source));
+            }
+
+            if (_delivery)
+            {
+                IS_ROS1_TRACE(publisher_queue, _trace, sequence);
+                _delivery->push(boost::make_shared<const Ros1_Msg>(*source));
+                return true;
+            }
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_shm_ring)
+            {
+                return send(*source, sequence);
+            }
+
+            if (const SerializedMessageCopy<Ros1_Msg>* serialized = SerializedCache<Ros1_Msg>::find(message))
+            {
+                return send(*serialized, sequence);
+            }
+
+            // The first ROS 1 publisher of this message publishes it as it is. If it fans out,
+            // the rest of them share one serialization, which the first one already takes care
+            // of when the topic is known to fan out.
+            if (_fanout_cache || SerializedCache<Ros1_Msg>::repeated(message))
+            {
+                return send(SerializedCache<Ros1_Msg>::store(message, *source, false), sequence);
+            }
+
+            return send(*source, sequence);
+        }
 
-        _publisher.publish(ros1_msg);
-        return true;
+        if (_delivery || _overflow)
+        {
+            // The held back messages cannot share a buffer, and the DynamicData
+            // is not guaranteed to outlive this call, so each one is converted on its own.
+            const boost::shared_ptr<Ros1_Msg> msg = boost::make_shared<Ros1_Msg>();
+
+            const MetricsStopwatch stopwatch;
+            convert_to_ros1(message, *msg);
+            IS_ROS1_TRACE(publisher_converted, _trace, sequence);
+
+            if (stopwatch.running())
+            {
+                _metrics->record(ros::serialization::serializationLength(*msg), stopwatch.elapsed_ns());
+            }
+
+            IS_ROS1_HOT_PATH_LOG(logger, utils::Logger::Level::INFO,
+                    "Holding message from Integration Service to ROS 1 back for topic '"
+                    << _topic_name << "': [[ " << message << " ]]");
+
+            IS_ROS1_TRACE(publisher_queue, _trace, sequence);
+            if (_overflow)
+            {
+                return _overflow->push(msg);
+            }
+
+            _delivery->push(msg);
+            return true;
+        }
+
+        if (_fanout_cache)
+        {
+            // Another ROS 1 publisher of the same type already converted this message.
+            if (const SerializedMessageCopy<Ros1_Msg>* serialized = SerializedCache<Ros1_Msg>::find(message))
+            {
+                if (metrics_enabled().load(std::memory_order_relaxed))
+                {
+                    _metrics->record(serialized->size, 0);
+                }
+
+                IS_ROS1_HOT_PATH_LOG(logger, utils::Logger::Level::INFO,
+                        "Sending cached message from Integration Service to ROS 1 for topic '"
+                        << _topic_name << "': [[ " << message << " ]]");
+
+                std::lock_guard<std::mutex> lock(_mutex);
+                return send(*serialized, sequence);
+            }
+        }
+
+        // The message buffer is reused between calls, so that the capacity of its
+        // containers survives. ros::Publisher serializes it before returning.
+        // It is only allocated by the publishers that ever convert on their own.
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_ros1_msg)
+        {
+            _ros1_msg = std::make_unique<Ros1_Msg>();
+        }
+
+        const MetricsStopwatch stopwatch;
+        convert_to_ros1(message, *_ros1_msg);
+        IS_ROS1_TRACE(publisher_converted, _trace, sequence);
+
+        if (stopwatch.running())
+        {
+            _metrics->record(ros::serialization::serializationLength(*_ros1_msg), stopwatch.elapsed_ns());
+        }
+
+        IS_ROS1_HOT_PATH_LOG(logger, utils::Logger::Level::INFO,
+                "Sending message from Integration Service to ROS 1 for topic '"
+                << _topic_name << "': [[ " << message << " ]]");
+
+        if (_fanout_cache)
+        {
+            return send(SerializedCache<Ros1_Msg>::store(message, *_ros1_msg, true), sequence);
+        }
+
+        return send(*_ros1_msg, sequence);
     }
 
 private:
 
+    void forward(
+            const boost::shared_ptr<const Ros1_Msg>& msg)
+    {
+        if (_delivery)
+        {
+            _delivery->push(msg);
+        }
+        else
+        {
+            send(*msg, 0);
+        }
+    }
+
+    bool send(
+            const SerializedMessageCopy<Ros1_Msg>& serialized,
+            uint64_t sequence)
+    {
+        if (_history)
+        {
+            _history->publish(_publisher, serialized);
+        }
+        else
+        {
+            _publisher.publish(serialized);
+        }
+
+        IS_ROS1_TRACE(publisher_sent, _trace, sequence);
+        return true;
+    }
+
+    bool send(
+            const Ros1_Msg& msg,
+            uint64_t sequence)
+    {
+        if (_history)
+        {
+            // The message is serialized once, both for the history and for the publication.
+            _history->publish(_publisher, msg);
+            IS_ROS1_TRACE(publisher_sent, _trace, sequence);
+            return true;
+        }
+
+        if (!_shm_ring)
+        {
+            _publisher.publish(msg);
+            IS_ROS1_TRACE(publisher_sent, _trace, sequence);
+            return true;
+        }
+
+        if (!_shm_ring->write(msg, _shm_handle.data))
+        {
+            IS_ROS1_HOT_PATH_LOG(logger, utils::Logger::Level::WARN,
+                    "Dropping message for topic '" << _topic_name << "': it does not fit in a "
+                    << _shm_ring->slot_size() << " bytes shared memory slot");
+
+            _metrics->dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        _publisher.publish(_shm_handle);
+        IS_ROS1_TRACE(publisher_sent, _trace, sequence);
+        return true;
+    }
+
     ros::Publisher _publisher;
     std::string _topic_name;
+    const std::shared_ptr<EntityMetrics> _metrics;
+
+    EntityTraceContext _trace;
+
+    std::mutex _mutex;
+    std::unique_ptr<Ros1_Msg> _ros1_msg;
+
+    const bool _fanout_cache;
+
+    const std::unique_ptr<SharedMemoryRing> _shm_ring;
+    std_msgs::UInt64 _shm_handle;
+
+    std::unique_ptr<HistoryCache<Ros1_Msg> > _history;
+
+    std::unique_ptr<DeliveryBuffer> _delivery;
+
+    std::unique_ptr<OverflowQueue> _overflow;
 };
 
 //==============================================================================
@@ -159,9 +623,31 @@ std::shared_ptr<is::TopicPublisher> make_publisher(
         ros::NodeHandle& node,
         const std::string& topic_name,
         const uint32_t queue_size,
-        const bool latch)
+        const bool latch,
+        const TopicOptions& options)
 {
-    return std::make_shared<Publisher>(node, topic_name, queue_size, latch);
+    std::unique_ptr<SharedMemoryRing> shm_ring;
+    if (options.shared_memory.enabled)
+    {
+        std::string error;
+        shm_ring = SharedMemoryRing::create(
+            options.shared_memory.for_topic(topic_name),
+            ros::message_traits::datatype<Ros1_Msg>(),
+            ros::message_traits::md5sum<Ros1_Msg>(),
+            error);
+
+        if (!shm_ring)
+        {
+            logger << utils::Logger::Level::ERROR
+                   << "Failed to create publisher for topic '" << topic_name
+                   << "': " << error << std::endl;
+
+            return nullptr;
+        }
+    }
+
+    return std::make_shared<Publisher>(
+        node, topic_name, queue_size, latch, options, std::move(shm_ring));
 }
 
 namespace {
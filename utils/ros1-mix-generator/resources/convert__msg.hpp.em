@@ -37,6 +37,13 @@ BUILTIN_TYPES = {
     'uint64'  : 'uint64_t'
 }
 
+# Fixed-width primitives whose arrays have the same memory layout in ROS 1 and in xTypes.
+# 'bool' and 'char' are left out: ROS 1 stores them as uint8_t, but xTypes does not.
+BULK_COPY_TYPES = [
+    'byte', 'int8', 'uint8', 'int16', 'uint16', 'int32', 'uint32',
+    'int64', 'uint64', 'float32', 'float64'
+]
+
 cpp_msg_type = '{}::{}'.format(package, type)
 
 msg_type_string = '{}/{}'.format(package, type)
@@ -97,7 +104,7 @@ const std::string g_msg_name = "@(msg_type_string)";
 
 
 //==============================================================================
-inline const xtypes::StructType type()
+inline const xtypes::StructType make_type()
 {
     xtypes::StructType type(g_msg_name);
 @[for field in spec.parsed_fields()]@
@@ -128,10 +135,32 @@ inline const xtypes::StructType type()
 }
 
 //==============================================================================
+// The type is built on first use and shared from then on, both by the Factory,
+// which hands it over to Integration Service and to every proxy of the type,
+// and by the types of the messages that contain it.
+inline const xtypes::DynamicType::Ptr& shared_type()
+{
+    static const xtypes::DynamicType::Ptr type(make_type());
+    return type;
+}
+
+//==============================================================================
+inline const xtypes::StructType& type()
+{
+    return static_cast<const xtypes::StructType&>(*shared_type());
+}
+
+//==============================================================================
+// Members are accessed by index, following the order in which make_type() adds them,
+// so that no member name lookup takes place during the conversion.
 inline void convert_to_ros1(const xtypes::ReadableDynamicDataRef& from, Ros1_Msg& to)
 {
-@[for field in spec.parsed_fields()]@
-    is::utils::Convert<Ros1_Msg::_@(field.name)_type>::from_xtype_field(from["@(field.name)"], to.@(field.name));
+@[for index, field in enumerate(spec.parsed_fields())]@
+@[    if field.is_array and field.base_type in BULK_COPY_TYPES]@
+    is::sh::ros1::convert__primitive_sequence::convert_to_ros1(from[@(index)], to.@(field.name));
+@[    else]@
+    is::utils::Convert<Ros1_Msg::_@(field.name)_type>::from_xtype_field(from[@(index)], to.@(field.name));
+@[    end if]@
 @[end for]@
 
     // Suppress possible unused variable warnings
@@ -142,8 +171,15 @@ inline void convert_to_ros1(const xtypes::ReadableDynamicDataRef& from, Ros1_Msg
 //==============================================================================
 inline void convert_to_xtype(const Ros1_Msg& from, xtypes::WritableDynamicDataRef to)
 {
-@[for field in spec.parsed_fields()]@
-    is::utils::Convert<Ros1_Msg::_@(field.name)_type>::to_xtype_field(from.@(field.name), to["@(field.name)"]);
+@[for index, field in enumerate(spec.parsed_fields())]@
+@[    if field.is_array and field.base_type in BULK_COPY_TYPES]@
+    is::sh::ros1::convert__primitive_sequence::convert_to_xtype(from.@(field.name), to[@(index)]);
+@[    elif field.is_array]@
+    is::sh::ros1::convert__sequence::shrink(to[@(index)], from.@(field.name).size());
+    is::utils::Convert<Ros1_Msg::_@(field.name)_type>::to_xtype_field(from.@(field.name), to[@(index)]);
+@[    else]@
+    is::utils::Convert<Ros1_Msg::_@(field.name)_type>::to_xtype_field(from.@(field.name), to[@(index)]);
+@[    end if]@
 @[end for]@
 
     // Suppress possible unused variable warnings
@@ -37,6 +37,13 @@ BUILTIN_TYPES = {
     'uint64'  : 'uint64_t'
 }
 
+# Fixed-width primitives whose arrays have the same memory layout in ROS 1 and in xTypes.
+# 'bool' and 'char' are left out: ROS 1 stores them as uint8_t, but xTypes does not.
+BULK_COPY_TYPES = [
+    'byte', 'int8', 'uint8', 'int16', 'uint16', 'int32', 'uint32',
+    'int64', 'uint64', 'float32', 'float64'
+]
+
 cpp_srv_type = '{}::{}'.format(package, type)
 cpp_request_type = cpp_srv_type + 'Request'
 cpp_response_type = cpp_srv_type + 'Response'
@@ -65,11 +72,20 @@ for component, msg in {"request": spec.request, "response": spec.response}.items
 #include <is/core/Message.hpp>
 
 // Include the header for the conversions
-#include <is/utils/Convert.hpp>
+#include <is/sh/ros1/utilities.hpp>
 
 // Include the header for the logger
 #include <is/utils/Log.hpp>
 
+// Include the header for the per-message log traces
+#include <is/sh/ros1/Log.hpp>
+
+// Include the header for the runtime metrics
+#include <is/sh/ros1/Metrics.hpp>
+
+// Include the header for the per-call tracepoints
+#include <is/sh/ros1/Tracing.hpp>
+
 // Include the header for the concrete service type
 #include <@(ros1_srv_dependency)>
 
@@ -84,11 +100,23 @@ for component, msg in {"request": spec.request, "response": spec.response}.items
 // Include the NodeHandle API so we can provide and request services
 #include <ros/node_handle.h>
 
+// Include the Boost thread API, which allows to choose the stack size of the workers
+#include <boost/thread/thread.hpp>
+
 // Include the STL API for std::future
 #include <future>
 
-// Include the STL API for std::unordered_set
-#include <unordered_set>
+// Include the STL APIs for the ServerProxy worker pool
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace eprosima {
 namespace is {
@@ -147,10 +175,16 @@ TypeToFactoryRegistrar register_@(component)_type(g_@(component)_name, &@(compon
 } //  anonymous namespace
 
 //==============================================================================
+// Members are accessed by index, following the order in which request_type() and
+// response_type() add them, so that no member name lookup takes place during the conversion.
 void request_to_ros1(const xtypes::ReadableDynamicDataRef& from, Ros1_Request& to)
 {
-@[for field in spec.request.parsed_fields()]@
-    is::utils::Convert<Ros1_Request::_@(field.name)_type>::from_xtype_field(from["@(field.name)"], to.@(field.name));
+@[for index, field in enumerate(spec.request.parsed_fields())]@
+@[    if field.is_array and field.base_type in BULK_COPY_TYPES]@
+    is::sh::ros1::convert__primitive_sequence::convert_to_ros1(from[@(index)], to.@(field.name));
+@[    else]@
+    is::utils::Convert<Ros1_Request::_@(field.name)_type>::from_xtype_field(from[@(index)], to.@(field.name));
+@[    end if]@
 @[end for]@
 
     // Suppress possible unused variable warnings
@@ -161,8 +195,15 @@ void request_to_ros1(const xtypes::ReadableDynamicDataRef& from, Ros1_Request& t
 //==============================================================================
 void request_to_xtype(const Ros1_Request& from, xtypes::WritableDynamicDataRef to)
 {
-@[for field in spec.request.parsed_fields()]@
-    is::utils::Convert<Ros1_Request::_@(field.name)_type>::to_xtype_field(from.@(field.name), to["@(field.name)"]);
+@[for index, field in enumerate(spec.request.parsed_fields())]@
+@[    if field.is_array and field.base_type in BULK_COPY_TYPES]@
+    is::sh::ros1::convert__primitive_sequence::convert_to_xtype(from.@(field.name), to[@(index)]);
+@[    elif field.is_array]@
+    is::sh::ros1::convert__sequence::shrink(to[@(index)], from.@(field.name).size());
+    is::utils::Convert<Ros1_Request::_@(field.name)_type>::to_xtype_field(from.@(field.name), to[@(index)]);
+@[    else]@
+    is::utils::Convert<Ros1_Request::_@(field.name)_type>::to_xtype_field(from.@(field.name), to[@(index)]);
+@[    end if]@
 @[end for]@
 
     (void)from;
@@ -172,8 +213,12 @@ void request_to_xtype(const Ros1_Request& from, xtypes::WritableDynamicDataRef t
 //==============================================================================
 void response_to_ros1(const xtypes::ReadableDynamicDataRef& from, Ros1_Response& to)
 {
-@[for field in spec.response.parsed_fields()]@
-    is::utils::Convert<Ros1_Response::_@(field.name)_type>::from_xtype_field(from["@(field.name)"], to.@(field.name));
+@[for index, field in enumerate(spec.response.parsed_fields())]@
+@[    if field.is_array and field.base_type in BULK_COPY_TYPES]@
+    is::sh::ros1::convert__primitive_sequence::convert_to_ros1(from[@(index)], to.@(field.name));
+@[    else]@
+    is::utils::Convert<Ros1_Response::_@(field.name)_type>::from_xtype_field(from[@(index)], to.@(field.name));
+@[    end if]@
 @[end for]@
 
     (void)from;
@@ -183,8 +228,15 @@ void response_to_ros1(const xtypes::ReadableDynamicDataRef& from, Ros1_Response&
 //==============================================================================
 void response_to_xtype(const Ros1_Response& from, xtypes::WritableDynamicDataRef to)
 {
-@[for field in spec.response.parsed_fields()]@
-    is::utils::Convert<Ros1_Response::_@(field.name)_type>::to_xtype_field(from.@(field.name), to["@(field.name)"]);
+@[for index, field in enumerate(spec.response.parsed_fields())]@
+@[    if field.is_array and field.base_type in BULK_COPY_TYPES]@
+    is::sh::ros1::convert__primitive_sequence::convert_to_xtype(from.@(field.name), to[@(index)]);
+@[    elif field.is_array]@
+    is::sh::ros1::convert__sequence::shrink(to[@(index)], from.@(field.name).size());
+    is::utils::Convert<Ros1_Response::_@(field.name)_type>::to_xtype_field(from.@(field.name), to[@(index)]);
+@[    else]@
+    is::utils::Convert<Ros1_Response::_@(field.name)_type>::to_xtype_field(from.@(field.name), to[@(index)]);
+@[    end if]@
 @[end for]@
 
     (void)from;
@@ -199,12 +251,15 @@ public:
     ClientProxy(
             ros::NodeHandle& node,
             const std::string& service_name,
-            ServiceClientSystem::RequestCallback* callback)
+            ServiceClientSystem::RequestCallback* callback,
+            const YAML::Node& configuration)
         : _callback(callback)
-        , _handle(std::make_shared<PromiseHolder>())
-        , _request_type(request_type())
-        , _request_data(*_request_type)
         , _service_name(service_name)
+        , _request_type(Factory::instance().create_type(g_request_name))
+        , _timeout(configuration["timeout_ms"].as<uint32_t>(0))
+        , _timed_out_calls(0)
+        , _metrics(Metrics::instance().create("service_client", service_name))
+        , _trace(service_name)
     {
         _service = node.advertiseService(
             service_name, &ClientProxy::service_callback, this);
@@ -217,52 +272,117 @@ public:
         const std::shared_ptr<PromiseHolder>& handle =
                 std::static_pointer_cast<PromiseHolder>(call_handle);
 
-        response_to_ros1(result, _response);
+        Ros1_Response response;
+        response_to_ros1(result, response);
+        IS_ROS1_TRACE(client_response, _trace, handle->sequence);
+
+        IS_ROS1_HOT_PATH_LOG(logger, utils::Logger::Level::INFO,
+                "Translating reply from Integration Service to ROS 1 for service reply topic '"
+                << _service_name << "_Reply': [[ " << response << " ]]");
 
-        logger << utils::Logger::Level::INFO
-               << "Translating reply from Integration Service to ROS 1 for service reply topic '"
-               << _service_name << "_Reply': [[ " << _response << " ]]" << std::endl;
+        handle->promise.set_value(std::move(response));
+    }
 
-        handle->promise->set_value(_response);
+    /**
+     * @brief Number of ROS 1 requests that did not get a reply before their timeout expired.
+     */
+    uint64_t timed_out_calls() const
+    {
+        return _timed_out_calls;
     }
 
 private:
 
+    /**
+     * The service is served from its own callback queue, by a pool of threads,
+     * so several requests can be waiting for their reply at the same time without
+     * stalling the rest of the bridge. Therefore, every piece of per-request state
+     * lives in this call, or in the handle passed to the Integration Service core.
+     */
     bool service_callback(
             Ros1_Request& request,
             Ros1_Response& response)
     {
 
-        logger << utils::Logger::Level::INFO
-               << "Receiving request from ROS 1 for service request topic '"
-               << _service_name << "_Request'" << std::endl;
+        IS_ROS1_HOT_PATH_LOG(logger, utils::Logger::Level::INFO,
+                "Receiving request from ROS 1 for service request topic '"
+                << _service_name << "_Request'");
 
-        request_to_xtype(request, _request_data);
+        const MetricsStopwatch stopwatch;
+        const InFlight in_flight(*_metrics);
+        IS_ROS1_TRACE_BEGIN(client_request, _trace, sequence);
 
-        std::promise<Ros1_Response> response_promise;
-        _handle->promise = &response_promise;
+        xtypes::DynamicData request_data(*_request_type);
+        request_to_xtype(request, request_data);
 
-        std::future<Ros1_Response> future_response = response_promise.get_future();
-        (*_callback)(_request_data, *this, _handle);
+        const std::shared_ptr<PromiseHolder> handle = std::make_shared<PromiseHolder>();
+        handle->sequence = sequence;
+        std::future<Ros1_Response> future_response = handle->promise.get_future();
 
-        future_response.wait();
+        (*_callback)(request_data, *this, handle);
+        IS_ROS1_TRACE(client_forwarded, _trace, sequence);
+
+        // A late reply is still delivered to the promise held by the handle,
+        // and then discarded along with it.
+        if (_timeout.count() > 0
+                && std::future_status::ready != future_response.wait_for(_timeout))
+        {
+            logger << utils::Logger::Level::WARN
+                   << "Call to service '" << _service_name << "' timed out after "
+                   << _timeout.count() << " ms (" << ++_timed_out_calls
+                   << " timed out calls so far)" << std::endl;
+
+            _metrics->dropped.fetch_add(1, std::memory_order_relaxed);
+            IS_ROS1_TRACE(client_timeout, _trace, sequence);
+
+            // Reported to the ROS 1 caller as a failed call.
+            return false;
+        }
 
         response = future_response.get();
+        IS_ROS1_TRACE(client_replied, _trace, sequence);
+
+        if (stopwatch.running())
+        {
+            _metrics->record(ros::serialization::serializationLength(request), stopwatch.elapsed_ns());
+        }
 
         return true;
     }
 
+    /**
+     * Accounts for a request of the ROS 1 client while it waits for its reply.
+     */
+    struct InFlight
+    {
+        explicit InFlight(
+                EntityMetrics& metrics)
+            : _metrics(metrics)
+        {
+            _metrics.in_flight.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        ~InFlight()
+        {
+            _metrics.in_flight.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        EntityMetrics& _metrics;
+    };
+
     struct PromiseHolder
     {
-        std::promise<Ros1_Response>* promise;
+        std::promise<Ros1_Response> promise;
+        uint64_t sequence = 0;
     };
 
     ServiceClientSystem::RequestCallback* _callback;
-    const std::shared_ptr<PromiseHolder> _handle;
     std::string _service_name;
     const xtypes::DynamicType::Ptr _request_type;
-    xtypes::DynamicData _request_data;
-    Ros1_Response _response;
+    const std::chrono::milliseconds _timeout;
+    std::atomic<uint64_t> _timed_out_calls;
+    const std::shared_ptr<EntityMetrics> _metrics;
+    EntityTraceContext _trace;
     ros::ServiceServer _service;
 
 };
@@ -271,230 +391,699 @@ private:
 std::shared_ptr<is::ServiceClient> make_client(
         ros::NodeHandle& node,
         const std::string& service_name,
-        ServiceClientSystem::RequestCallback* callback)
+        ServiceClientSystem::RequestCallback* callback,
+        const YAML::Node& configuration)
 {
-    return std::make_shared<ClientProxy>(node, service_name, callback);
+    return std::make_shared<ClientProxy>(node, service_name, callback, configuration);
 }
 
 namespace {
 ServiceClientToFactoryRegistrar register_client(g_response_name, &make_client);
 } //  anonymous namespace
 
-class ServerProxy;
-class ServerWorker;
-using ServerWorkerPtr = std::shared_ptr<ServerWorker>;
-
-//==============================================================================
-struct ServerWorkContext
-{
-    ServerWorkContext()
-        : run(false)
-        , quit(false)
-    {
-    }
-
-    Ros1_Request request;
-    bool run;
-    bool quit;
-
-    is::ServiceClient* is_client;
-    std::shared_ptr<void> call_handle;
-};
-
-//==============================================================================
-void server_worker_thread(
-        ros::NodeHandle& node,
-        std::string service_name,
-        const xtypes::DynamicType::Ptr response_type,
-        ServerProxy* const owner,
-        const ServerWorkerPtr worker,
-        std::mutex& mutex,
-        std::condition_variable& cv,
-        ServerWorkContext& context);
-
 //==============================================================================
-class ServerWorker : public std::enable_shared_from_this<ServerWorker>
+/**
+ * The calls and workers of a ServerProxy. The workers share it, so that a worker still
+ * waiting for a hung ROS 1 service server when the proxy goes away can be left behind:
+ * it keeps the pool alive until its call returns, and then leaves.
+ */
+class ServerWorkerPool final : public std::enable_shared_from_this<ServerWorkerPool>
 {
 public:
 
-    ServerWorker(
+    ServerWorkerPool(
             ros::NodeHandle& node,
             const std::string& service_name,
-            ServerProxy* owner)
+            const YAML::Node& configuration)
         : _node(node)
         , _service_name(service_name)
-        , _response_type(response_type())
-        , _owner(owner)
+        , _response_type(Factory::instance().create_type(g_response_name))
+        , _error_response(*_response_type)
+        , _persistent(configuration["persistent"].as<bool>(false))
+        , _queue_size(std::max(1u, configuration["queue_size"].as<uint32_t>(64)))
+        , _max_in_flight(configuration["max_in_flight"].as<uint32_t>(0))
+        , _timeout(configuration["timeout_ms"].as<uint32_t>(0))
+        , _max_workers(std::max(1u, configuration["workers"].as<uint32_t>(4)))
+        , _worker_idle_timeout(configuration["worker_idle_timeout_ms"].as<uint32_t>(60000))
+        , _worker_stack_size(configuration["worker_stack_size"].as<std::size_t>(0))
+        , _worker_memory(_response_type->memory_size() + _worker_stack_size)
+        , _shutdown_timeout(configuration["shutdown_timeout_ms"].as<uint32_t>(1000))
+        , _quit(false)
+        , _abandoned(false)
+        , _idle_workers(0)
+        , _replying(0)
+        , _timed_out_calls(0)
+        , _rejected_calls(0)
+        , _failed_calls(0)
+        , _metrics(Metrics::instance().create("service_server", service_name))
+        , _trace(service_name)
     {
-        // Do nothing. The _thread cannot be instantiated here because its
-        // constructor requires the std::shared_ptr of this object, but
-        // shared_from_this() cannot be called until this constructor is finished.
+        if (_timeout.count() > 0)
+        {
+            _watchdog = std::thread(&ServerWorkerPool::watchdog_thread, this);
+        }
     }
 
-    ServerWorkerPtr deploy(
-            const xtypes::DynamicData& request,
-            is::ServiceClient& is_client,
-            std::shared_ptr<void> call_handle)
+    /**
+     * Stop the workers and answer every call still unanswered. The workers still waiting for
+     * the ROS 1 service server once the `shutdown_timeout_ms` expire are left behind, so that
+     * one hung server cannot block the shutdown of the bridge.
+     */
+    void shutdown()
     {
-        if (!_thread)
         {
-            // The first time this worker is deployed, we need to create the thread
-            _thread = std::make_unique<std::thread>([&]()
-                            {
-                                server_worker_thread(
-                                    _node, _service_name, _response_type, _owner,
-                                    shared_from_this(), _mutex, _cv, _context);
-                            });
+            std::unique_lock<std::mutex> lock(_mutex);
+            _quit = true;
+        }
+
+        _request_cv.notify_all();
+        _space_cv.notify_all();
+        _watchdog_cv.notify_all();
+
+        if (_watchdog.joinable())
+        {
+            _watchdog.join();
         }
 
+        // Once quitting, the workers leave without moving to the reaped list.
+        std::size_t abandoned_workers = 0;
         {
-            // Wait until the thread is not running so we can safely modify _context
             std::unique_lock<std::mutex> lock(_mutex);
+            _workers_cv.wait_for(lock, _shutdown_timeout, [this]()
+                    {
+                        return std::all_of(_workers.begin(), _workers.end(), [](const Worker& worker)
+                        {
+                            return worker.finished;
+                        });
+                    });
+
+            for (Worker& worker : _workers)
+            {
+                if (!worker.finished)
+                {
+                    worker.thread.detach();
+                    ++abandoned_workers;
+                }
+            }
+        }
 
-            // Update the request
-            request_to_ros1(request, _context.request);
+        for (WorkerList* workers : {&_workers, &_reaped_workers})
+        {
+            for (Worker& worker : *workers)
+            {
+                if (worker.thread.joinable())
+                {
+                    worker.thread.join();
+                }
+            }
+        }
 
-            // Update the client info
-            _context.is_client = &is_client;
-            _context.call_handle = std::move(call_handle);
+        std::vector<CallPtr> unanswered;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
 
-            // Instruct the thread to run
-            _context.run = true;
+            // From now on, the workers left behind do not reply: the clients may be gone.
+            // The replies already on their way are waited for.
+            _abandoned = true;
+            _replying_cv.wait(lock, [this]()
+                    {
+                        return 0 == _replying;
+                    });
+
+            unanswered.assign(_pending.begin(), _pending.end());
+            unanswered.insert(unanswered.end(), _executing.begin(), _executing.end());
+            _pending.clear();
         }
 
-        _cv.notify_one();
+        // The calls still queued, and the ones of the workers left behind, get their reply anyway.
+        for (const CallPtr& call : unanswered)
+        {
+            reply(call, _error_response);
+        }
 
-        return shared_from_this();
+        if (0 < abandoned_workers)
+        {
+            logger << utils::Logger::Level::WARN
+                   << "Leaving " << abandoned_workers << " worker(s) of service '" << _service_name
+                   << "' behind, still waiting for the ROS 1 service server after "
+                   << _shutdown_timeout.count() << " ms" << std::endl;
+        }
+
+        logger << utils::Logger::Level::DEBUG
+               << "Service '" << _service_name << "' finished with "
+               << _timed_out_calls << " timed out, " << _rejected_calls << " rejected and "
+               << _failed_calls << " failed calls" << std::endl;
     }
 
-    ~ServerWorker()
+    void call_service(
+            const xtypes::DynamicData& request,
+            ServiceClient& is_client,
+            std::shared_ptr<void> call_handle)
     {
-        // Have the working thread quit
+        IS_ROS1_HOT_PATH_LOG(logger, utils::Logger::Level::INFO,
+                "Translating request from Integration Service to ROS 1 for service request topic '"
+                << _service_name << "_Request': [[ " << request << " ]]");
+
+        IS_ROS1_TRACE_BEGIN(server_request, _trace, sequence);
+
+        const CallPtr call = std::make_shared<Call>();
+        call->sequence = sequence;
+        request_to_ros1(request, call->request);
+        call->is_client = &is_client;
+        call->call_handle = std::move(call_handle);
+        call->arrival = std::chrono::steady_clock::now();
+        call->deadline = (_timeout.count() > 0)
+                ? call->arrival + _timeout
+                : std::chrono::steady_clock::time_point::max();
+
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        if (0 < _max_in_flight && _pending.size() + _executing.size() >= _max_in_flight)
         {
-            std::unique_lock<std::mutex> lock(_mutex);
-            _context.quit = true;
+            lock.unlock();
+
+            logger << utils::Logger::Level::WARN
+                   << "Rejecting call to ROS 1 service '" << _service_name << "': "
+                   << _max_in_flight << " calls are already in flight ("
+                   << ++_rejected_calls << " rejected calls so far)" << std::endl;
+
+            _metrics->dropped.fetch_add(1, std::memory_order_relaxed);
+            reply(call, _error_response);
+            return;
+        }
+
+        // Apply backpressure: the caller waits until there is room in the queue.
+        _space_cv.wait(lock, [&]()
+                {
+                    return _pending.size() < _queue_size || _quit;
+                });
+
+        if (_quit)
+        {
+            lock.unlock();
+            reply(call, _error_response);
+            return;
+        }
+
+        // A call is in flight from the moment it is queued until it gets its reply.
+        call->in_flight = true;
+        _metrics->in_flight.fetch_add(1, std::memory_order_relaxed);
+        _pending.emplace_back(call);
+
+        // The workers are started on demand, so that idle services hold no threads.
+        if (_idle_workers < _pending.size() && _workers.size() < _max_workers)
+        {
+            start_worker();
         }
 
-        _cv.notify_one();
+        lock.unlock();
+
+        _request_cv.notify_one();
+        _watchdog_cv.notify_one();
+    }
+
+    /**
+     * @brief Number of calls that did not get a reply before their timeout expired.
+     */
+    uint64_t timed_out_calls() const
+    {
+        return _timed_out_calls;
+    }
+
+    /**
+     * @brief Number of calls rejected because max_in_flight calls were already in flight.
+     */
+    uint64_t rejected_calls() const
+    {
+        return _rejected_calls;
+    }
+
+    /**
+     * @brief Number of calls for which the ROS 1 service server reported a failure.
+     */
+    uint64_t failed_calls() const
+    {
+        return _failed_calls;
     }
 
 private:
 
-    ros::NodeHandle& _node;
+    struct Call
+    {
+        Ros1_Request request;
+        is::ServiceClient* is_client;
+        std::shared_ptr<void> call_handle;
+        std::chrono::steady_clock::time_point arrival;
+        std::chrono::steady_clock::time_point deadline;
+        std::atomic<bool> replied{false};
+        bool in_flight = false;
+        uint64_t sequence = 0;
+    };
 
-    const std::string _service_name;
+    using CallPtr = std::shared_ptr<Call>;
+
+    /**
+     * Each call gets exactly one reply: either the response of the ROS 1 service server,
+     * or the error response, if the call failed, timed out, was rejected or was dropped
+     * while shutting down. The error response is a default initialized response: the
+     * replies handed over to Integration Service carry no error status, so the client
+     * cannot tell it apart from a genuine reply, as the README warns.
+     */
+    bool reply(
+            const CallPtr& call,
+            const xtypes::DynamicData& response)
+    {
+        if (call->replied.exchange(true))
+        {
+            return false;
+        }
 
-    const xtypes::DynamicType::Ptr _response_type;
+        if (call->in_flight)
+        {
+            _metrics->in_flight.fetch_sub(1, std::memory_order_relaxed);
+        }
+        IS_ROS1_TRACE(server_reply, _trace, call->sequence);
+        call->is_client->receive_response(std::move(call->call_handle), response);
+        return true;
+    }
 
-    ServerProxy* const _owner;
+    struct Worker
+    {
+        boost::thread thread;
 
-    std::unique_ptr<std::thread> _thread;
+        /// Set by the worker thread, with the mutex held, right before leaving.
+        bool finished = false;
+    };
 
-    std::mutex _mutex;
+    using WorkerList = std::list<Worker>;
 
-    std::condition_variable _cv;
+    /**
+     * Must be called with the mutex held. The workers that were reaped meanwhile are joined
+     * first, which is quick, since they already left the loop.
+     */
+    void start_worker()
+    {
+        for (Worker& worker : _reaped_workers)
+        {
+            worker.thread.join();
+        }
+        _reaped_workers.clear();
 
-    ServerWorkContext _context;
-};
+        boost::thread::attributes attributes;
+        if (0 < _worker_stack_size)
+        {
+            attributes.set_stack_size(_worker_stack_size);
+        }
 
-//==============================================================================
-class ServerProxy final : public virtual is::ServiceProvider
-{
-public:
+        _workers.emplace_back();
+        const WorkerList::iterator self = std::prev(_workers.end());
+        self->thread = boost::thread(attributes, [pool = shared_from_this(), self]()
+                        {
+                            pool->worker_thread(self);
+                        });
 
-    ServerProxy(
-            ros::NodeHandle& node,
-            const std::string& service_name)
-    // Initialize the pool with 0 workers because we haven't given it the
-    // desired initialization function yet
-        : _node(&node)
-        , _workers(0)
-        , _service_name(service_name)
+        _metrics->memory.fetch_add(static_cast<int64_t>(_worker_memory), std::memory_order_relaxed);
+    }
+
+    /**
+     * Must be called with the mutex held, right before the worker leaves. Once reaped,
+     * the worker may be joined while the mutex is held, so it never takes it again.
+     */
+    void leave(
+            WorkerList::iterator self)
+    {
+        self->finished = true;
+        _workers_cv.notify_all();
+    }
+
+    void worker_thread(
+            WorkerList::iterator self)
     {
-        _workers.setInitializer([=]()
+        ros::ServiceClient ros1_client;
+        xtypes::DynamicData response(*_response_type);
+
+        while (true)
+        {
+            CallPtr call;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+
+                const auto has_work = [&]()
+                        {
+                            return !_pending.empty() || _quit;
+                        };
+
+                ++_idle_workers;
+                bool woken = true;
+                if (_worker_idle_timeout.count() > 0)
                 {
-                    return std::make_shared<ServerWorker>(*_node, service_name, this);
-                });
+                    woken = _request_cv.wait_for(lock, _worker_idle_timeout, has_work);
+                }
+                else
+                {
+                    _request_cv.wait(lock, has_work);
+                }
+                --_idle_workers;
+
+                if (_quit)
+                {
+                    leave(self);
+                    return;
+                }
+
+                if (!woken)
+                {
+                    // Idle for too long: release the thread, along with its connection and buffers.
+                    // It is joined by whoever starts the next worker, or while shutting down.
+                    _reaped_workers.splice(_reaped_workers.end(), _workers, self);
+                    _metrics->memory.fetch_sub(static_cast<int64_t>(_worker_memory), std::memory_order_relaxed);
+                    leave(self);
+                    return;
+                }
+
+                call = std::move(_pending.front());
+                _pending.pop_front();
+                _executing.push_back(call);
+            }
+
+            _space_cv.notify_one();
+
+            Ros1_Response ros1_response;
+            IS_ROS1_TRACE(server_call, _trace, call->sequence);
+            const bool success = this->call(ros1_client, call->request, ros1_response);
+            IS_ROS1_TRACE(server_returned, _trace, call->sequence);
+
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _executing.erase(std::find(_executing.begin(), _executing.end(), call));
+
+                if (_abandoned)
+                {
+                    // The proxy went away meanwhile, and answered the call itself.
+                    leave(self);
+                    return;
+                }
+
+                ++_replying;
+            }
+
+            finish(call, success, ros1_response, response);
+
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                --_replying;
+            }
+
+            _replying_cv.notify_all();
+        }
     }
 
-    void call_service(
-            const xtypes::DynamicData& request,
-            ServiceClient& is_client,
-            std::shared_ptr<void> call_handle) override
+    void finish(
+            const CallPtr& call,
+            bool success,
+            const Ros1_Response& ros1_response,
+            xtypes::DynamicData& response)
     {
-        logger << utils::Logger::Level::INFO
-               << "Translating request from Integration Service to ROS 1 for service request topic '"
-               << _service_name << "_Request': [[ " << request << " ]]" << std::endl;
+        if (call->replied)
+        {
+            // The call timed out while waiting for the ROS 1 service server.
+            return;
+        }
+
+        if (success)
+        {
+            response_to_xtype(ros1_response, response);
+            if (reply(call, response) && metrics_enabled().load(std::memory_order_relaxed))
+            {
+                _metrics->record(
+                    ros::serialization::serializationLength(ros1_response),
+                    static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - call->arrival).count()));
+            }
+        }
+        else
+        {
+            logger << utils::Logger::Level::ERROR
+                   << "Failed to call ROS 1 service '" << _service_name << "' ("
+                   << ++_failed_calls << " failed calls so far)" << std::endl;
 
-        _active.insert(_workers.pop()->deploy(request, is_client, std::move(call_handle)));
+            _metrics->errors.fetch_add(1, std::memory_order_relaxed);
+            reply(call, _error_response);
+        }
     }
 
-    void recycle_worker(
-            ServerWorkerPtr ptr)
+    /**
+     * roscpp service calls cannot be cancelled, so the watchdog sends the error response
+     * of the expired calls as soon as their deadline is reached, which releases the
+     * resources of the caller. A call waiting for a hung ROS 1 service server keeps its
+     * worker busy until the server answers or the connection drops, or until the worker
+     * is left behind while shutting down.
+     */
+    void watchdog_thread()
     {
-        _active.erase(ptr);
-        _workers.recycle(std::move(ptr));
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        while (!_quit)
+        {
+            const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            std::chrono::steady_clock::time_point next_deadline = now + _timeout;
+            std::vector<CallPtr> expired;
+
+            for (auto it = _pending.begin(); it != _pending.end();)
+            {
+                if ((*it)->deadline <= now)
+                {
+                    expired.push_back(std::move(*it));
+                    it = _pending.erase(it);
+                }
+                else
+                {
+                    next_deadline = std::min(next_deadline, (*it)->deadline);
+                    ++it;
+                }
+            }
+
+            for (const CallPtr& call : _executing)
+            {
+                if (call->replied)
+                {
+                    continue;
+                }
+
+                if (call->deadline <= now)
+                {
+                    expired.push_back(call);
+                }
+                else
+                {
+                    next_deadline = std::min(next_deadline, call->deadline);
+                }
+            }
+
+            if (expired.empty())
+            {
+                _watchdog_cv.wait_until(lock, next_deadline);
+                continue;
+            }
+
+            lock.unlock();
+            _space_cv.notify_all();
+
+            for (const CallPtr& call : expired)
+            {
+                if (reply(call, _error_response))
+                {
+                    _metrics->dropped.fetch_add(1, std::memory_order_relaxed);
+
+                    logger << utils::Logger::Level::WARN
+                           << "Call to ROS 1 service '" << _service_name << "' timed out after "
+                           << _timeout.count() << " ms (" << ++_timed_out_calls
+                           << " timed out calls so far)" << std::endl;
+                }
+            }
+
+            lock.lock();
+        }
     }
 
-private:
+    bool call(
+            ros::ServiceClient& ros1_client,
+            Ros1_Request& request,
+            Ros1_Response& response)
+    {
+        // Persistent clients keep their connection between calls, so each worker
+        // pays for the service lookup and connection setup only once. If a call
+        // fails because the connection dropped, the client is created again and the
+        // call is retried once. A call that the server handled and reported as failed
+        // leaves the connection valid, and is never repeated.
+        for (int attempt = 0; attempt < 2; ++attempt)
+        {
+            if (!ros1_client.isValid())
+            {
+                // Once quitting, this worker may be left behind, and the node handle may be gone.
+                if (quitting())
+                {
+                    break;
+                }
 
-    // Keep the node pointer so we can spawn more ServerWorkers when needed
-    ros::NodeHandle* _node;
+                ros1_client = _node.serviceClient<Ros1_Srv>(_service_name, _persistent);
+            }
 
-    is::utils::ResourcePool<ServerWorkerPtr, &is::utils::initialize_shared_null<ServerWorker> > _workers;
+            if (ros1_client.call(request, response))
+            {
+                return true;
+            }
 
-    std::unordered_set<ServerWorkerPtr> _active;
+            if (!_persistent || ros1_client.isValid())
+            {
+                break;
+            }
 
-    std::string _service_name;
+            ros1_client.shutdown();
+        }
+
+        return false;
+    }
+
+    bool quitting()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        return _quit;
+    }
+
+    ros::NodeHandle& _node;
+
+    const std::string _service_name;
+
+    const xtypes::DynamicType::Ptr _response_type;
+
+    const xtypes::DynamicData _error_response;
+
+    const bool _persistent;
+
+    const std::size_t _queue_size;
+
+    const std::size_t _max_in_flight;
+
+    const std::chrono::milliseconds _timeout;
+
+    const std::size_t _max_workers;
+
+    const std::chrono::milliseconds _worker_idle_timeout;
+
+    const std::size_t _worker_stack_size;
+
+    /// What the metrics account for each running worker.
+    const std::size_t _worker_memory;
+
+    const std::chrono::milliseconds _shutdown_timeout;
+
+    std::mutex _mutex;
+
+    std::condition_variable _request_cv;
+
+    std::condition_variable _space_cv;
+
+    std::condition_variable _watchdog_cv;
+
+    std::deque<CallPtr> _pending;
+
+    std::vector<CallPtr> _executing;
+
+    std::condition_variable _replying_cv;
+
+    std::condition_variable _workers_cv;
+
+    bool _quit;
+
+    /// Set once the proxy is gone, for the workers left behind.
+    bool _abandoned;
+
+    std::size_t _idle_workers;
+
+    /// The number of workers replying to a call right now.
+    std::size_t _replying;
+
+    std::atomic<uint64_t> _timed_out_calls;
+
+    std::atomic<uint64_t> _rejected_calls;
+
+    std::atomic<uint64_t> _failed_calls;
+
+    const std::shared_ptr<EntityMetrics> _metrics;
+
+    EntityTraceContext _trace;
+
+    WorkerList _workers;
+
+    WorkerList _reaped_workers;
+
+    std::thread _watchdog;
 
 };
 
 //==============================================================================
-void server_worker_thread(
-        ros::NodeHandle& node,
-        std::string service_name,
-        const xtypes::DynamicType::Ptr response_type,
-        ServerProxy* const owner,
-        const ServerWorkerPtr worker,
-        std::mutex& mutex,
-        std::condition_variable& cv,
-        ServerWorkContext& context)
+class ServerProxy final : public virtual is::ServiceProvider
 {
-    ros::ServiceClient ros1_client = node.serviceClient<Ros1_Srv>(service_name);
-    Ros1_Response ros1_response;
+public:
 
-    while (true)
+    ServerProxy(
+            ros::NodeHandle& node,
+            const std::string& service_name,
+            const YAML::Node& configuration)
+        : _pool(std::make_shared<ServerWorkerPool>(node, service_name, configuration))
     {
-        std::unique_lock<std::mutex> lock(mutex);
-        cv.wait(lock, [&]()
-                {
-                    return context.run || context.quit;
-                });
-
-        if (context.quit)
-        {
-            return;
-        }
+    }
 
-        xtypes::DynamicData response(*response_type);
+    ~ServerProxy()
+    {
+        _pool->shutdown();
+    }
 
-        ros1_client.call(context.request, ros1_response);
+    void call_service(
+            const xtypes::DynamicData& request,
+            ServiceClient& is_client,
+            std::shared_ptr<void> call_handle) override
+    {
+        _pool->call_service(request, is_client, std::move(call_handle));
+    }
 
-        response_to_xtype(ros1_response, response);
+    /**
+     * @brief Number of calls that did not get a reply before their timeout expired.
+     */
+    uint64_t timed_out_calls() const
+    {
+        return _pool->timed_out_calls();
+    }
 
-        context.is_client->receive_response(std::move(context.call_handle), response);
+    /**
+     * @brief Number of calls rejected because max_in_flight calls were already in flight.
+     */
+    uint64_t rejected_calls() const
+    {
+        return _pool->rejected_calls();
+    }
 
-        context.run = false;
-        owner->recycle_worker(worker);
+    /**
+     * @brief Number of calls for which the ROS 1 service server reported a failure.
+     */
+    uint64_t failed_calls() const
+    {
+        return _pool->failed_calls();
     }
-}
+
+private:
+
+    const std::shared_ptr<ServerWorkerPool> _pool;
+};
 
 //==============================================================================
 std::shared_ptr<is::ServiceProvider> make_server(
         ros::NodeHandle& node,
-        const std::string& service_name)
+        const std::string& service_name,
+        const YAML::Node& configuration)
 {
-    return std::make_shared<ServerProxy>(node, service_name);
+    return std::make_shared<ServerProxy>(node, service_name, configuration);
 }
 
 namespace {
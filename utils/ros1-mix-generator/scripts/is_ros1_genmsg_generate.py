@@ -13,6 +13,9 @@ except ImportError:
 import argparse
 import copy
 import em
+import hashlib
+import json
+import multiprocessing
 import os
 import sys
 
@@ -24,6 +27,10 @@ else:
 
 g_msg_context = MsgContext()
 
+# Name of the file, within the source directory, that records the content hash
+# of the inputs each generated file was rendered from.
+g_hash_cache_name = '.is_ros1_genmsg_hashes.json'
+
 
 def get_type_components(full_type):
     if full_type == 'Header':
@@ -62,7 +69,7 @@ def parse_service_file(srv_file, srv_name):
     return load_srv_from_file(g_msg_context, srv_file, srv_name)
 
 
-def generate_file(template, destination, context):
+def output_file_path(template, destination, idl_file):
 
     base_name = template.split('/')[-1]
     base_name_components = base_name.split('.')
@@ -71,43 +78,120 @@ def generate_file(template, destination, context):
     if base_name_components[-1] == 'em':
         base_name_components.pop(-1)
 
-    package_name, type_name = get_type_components(context['spec'].full_name)
-    context['package'] = package_name
-    context['type'] = type_name
-
     # Add the message type name to the source file
+    type_name = idl_file.split('/')[-1][:-4]
     base_name_components[0] = base_name_components[0] + '__' + type_name
     filename = '.'.join(base_name_components)
-    output_file_path = '/'.join([destination, filename])
+    return '/'.join([destination, filename])
+
+
+def write_if_changed(path, content):
+    # Leaving untouched the files whose content did not change keeps their timestamp,
+    # so that the build system does not compile them again.
+    if os.path.exists(path):
+        with open(path, 'r') as file:
+            if file.read() == content:
+                return False
+
+    destination = os.path.dirname(path)
+    if not os.path.exists(destination):
+        try:
+            os.makedirs(destination)
+        except OSError:
+            # Another worker may have created it meanwhile
+            if not os.path.isdir(destination):
+                raise
+
+    with open(path, 'w') as file:
+        file.write(content)
+    return True
+
+
+def generate_file(template, output_path, context):
+
+    package_name, type_name = get_type_components(context['spec'].full_name)
+    context['package'] = package_name
+    context['type'] = type_name
 
     output_buffer = BufferIO()
     interpreter = em.Interpreter(output=output_buffer, globals=copy.deepcopy(context))
-    interpreter.file(open(template, 'r'))
+    with open(template, 'r') as template_file:
+        interpreter.file(template_file)
 
-    if not os.path.exists(destination):
-        os.makedirs(destination)
+    return write_if_changed(output_path, output_buffer.getvalue())
+
+
+def file_digest(path):
+    with open(path, 'rb') as file:
+        return hashlib.sha256(file.read()).hexdigest()
+
+
+def input_hash(idl_file, template, digests):
+    # A generated file only depends on its template, on the specification it is rendered from,
+    # and on this very script.
+    hash = hashlib.sha256()
+    for path in (os.path.abspath(__file__), template, idl_file):
+        hash.update(digests[path].encode('utf-8'))
+    return hash.hexdigest()
+
+
+def generate_idl(job):
+
+    package, prefix, idl_file, outputs, kind = job
+    parse_fnc = parse_message_file if kind == 'msg' else parse_service_file
 
-    with open(output_file_path, 'w') as file:
-        file.write(output_buffer.getvalue())
+    name = package + '/' + idl_file.split('/')[-1][:-4]
 
+    context = {
+        'spec': parse_fnc(idl_file, name),
+        'subdir': prefix,
+        'get_type_components': get_type_components
+    }
 
-def generate_files(package, source_dir, header_dir, idl_files, cpp_files, hpp_files, prefix, parse_fnc):
+    written = 0
+    for template, output_path in outputs:
+        if generate_file(template, output_path, context):
+            written += 1
+    return written
 
+
+def plan_files(package, source_dir, header_dir, idl_files, cpp_files, hpp_files, prefix, kind,
+               digests, hashes, new_hashes):
+
+    jobs = []
     for idl_file in idl_files:
 
-        name = package + '/' + idl_file.split('/')[-1][:-4]
+        outputs = []
+        for templates, directory in ((cpp_files, source_dir), (hpp_files, header_dir)):
+            for template in templates:
+                output_path = output_file_path(template, directory + '/' + prefix, idl_file)
+                new_hashes[output_path] = input_hash(idl_file, template, digests)
+
+                # Skip the files rendered from the very same inputs by a previous run.
+                if hashes.get(output_path) != new_hashes[output_path] or not os.path.exists(output_path):
+                    outputs.append((template, output_path))
+
+        if outputs:
+            jobs.append((package, prefix, idl_file, outputs, kind))
 
-        context = {
-            'spec': parse_fnc(idl_file, name),
-            'subdir': prefix,
-            'get_type_components': get_type_components
-        }
+    return jobs
 
-        for cpp_file in cpp_files:
-            generate_file(cpp_file, source_dir + '/' + prefix, context)
 
-        for hpp_file in hpp_files:
-            generate_file(hpp_file, header_dir + '/' + prefix, context)
+def load_hashes(path):
+    try:
+        with open(path, 'r') as file:
+            return json.load(file)
+    except (IOError, OSError, ValueError):
+        return {}
+
+
+def default_jobs():
+    value = os.environ.get('IS_ROS1_GENMSG_JOBS', '')
+    try:
+        return max(0, int(value)) if value else 0
+    except ValueError:
+        print('Ignoring IS_ROS1_GENMSG_JOBS={!r}, which is not a number'.format(value), file=sys.stderr)
+        return 0
 
 
 def main(cli_args):
@@ -128,16 +212,46 @@ def main(cli_args):
                         help='EmPy templates for .cpp files, each one will be applied to each service idl')
     parser.add_argument('--srv-hpp-files', nargs='*', required=True,
                         help='EmPy templates for .hpp files, each one will be applied to each service idl')
+    parser.add_argument('--jobs', type=int, default=default_jobs(),
+                        help='Number of idl files rendered in parallel. Defaults to the IS_ROS1_GENMSG_JOBS '
+                             'environment variable or, if it is not set, to the number of cores')
 
     args = parser.parse_args(cli_args[1:])
 
-    generate_files(args.package, args.source_dir, args.header_dir,
-                   args.msg_idl_files, args.msg_cpp_files, args.msg_hpp_files,
-                   'msg', parse_message_file)
+    inputs = set([os.path.abspath(__file__)])
+    for files in (args.msg_idl_files, args.msg_cpp_files, args.msg_hpp_files,
+                  args.srv_idl_files, args.srv_cpp_files, args.srv_hpp_files):
+        inputs.update(files)
+    digests = dict((path, file_digest(path)) for path in inputs)
+
+    hash_cache_path = os.path.join(args.source_dir, g_hash_cache_name)
+    hashes = load_hashes(hash_cache_path)
+    new_hashes = {}
+
+    jobs = plan_files(args.package, args.source_dir, args.header_dir,
+                      args.msg_idl_files, args.msg_cpp_files, args.msg_hpp_files,
+                      'msg', 'msg', digests, hashes, new_hashes)
+
+    jobs += plan_files(args.package, args.source_dir, args.header_dir,
+                       args.srv_idl_files, args.srv_cpp_files, args.srv_hpp_files,
+                       'srv', 'srv', digests, hashes, new_hashes)
+
+    jobs_count = args.jobs if args.jobs > 0 else multiprocessing.cpu_count()
+    if jobs_count > 1 and len(jobs) > 1:
+        pool = multiprocessing.Pool(min(jobs_count, len(jobs)))
+        try:
+            written = sum(pool.map(generate_idl, jobs))
+        finally:
+            pool.close()
+            pool.join()
+    else:
+        written = sum(generate_idl(job) for job in jobs)
+
+    # Record the hashes only once every file was generated, so that a failed run is redone.
+    write_if_changed(hash_cache_path, json.dumps(new_hashes, indent=2, sort_keys=True))
 
-    generate_files(args.package, args.source_dir, args.header_dir,
-                   args.srv_idl_files, args.srv_cpp_files, args.srv_hpp_files,
-                   'srv', parse_service_file)
+    if written:
+        print('{}: {} generated files changed'.format(args.package, written), file=sys.stderr)
 
 
 if __name__ == '__main__':